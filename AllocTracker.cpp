@@ -0,0 +1,82 @@
+#include "AllocTracker.h"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+AllocTracker g_AllocTracker;
+
+thread_local size_t AllocTracker::t_CurrentZone = 0;
+
+// MSVC's CRT has no aligned_alloc, and its aligned blocks must be freed
+// with _aligned_free rather than free
+static void* AlignedAllocate(std::size_t size, std::size_t align)
+{
+#if defined(_WIN32)
+	return _aligned_malloc(size ? size : 1, align);
+#else
+	return std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+}
+
+static void AlignedFree(void* ptr)
+{
+#if defined(_WIN32)
+	_aligned_free(ptr);
+#else
+	std::free(ptr);
+#endif
+}
+
+// Replacing the global operator new is enough to see every container node,
+// shared_ptr control block and vector growth. The array and nothrow forms
+// forward here by default.
+void* operator new(std::size_t size)
+{
+	g_AllocTracker.OnAllocate(size);
+	if (void* ptr = std::malloc(size ? size : 1))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	g_AllocTracker.OnAllocate(size);
+	if (void* ptr = AlignedAllocate(size, (size_t)alignment))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	g_AllocTracker.OnAllocate(size);
+	return AlignedAllocate(size, (size_t)alignment);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+	AlignedFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+	AlignedFree(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	AlignedFree(ptr);
+}
@@ -0,0 +1,192 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+
+const size_t ALLOC_MAX_ZONES = 32;
+
+struct AllocZone
+{
+	const char* name = nullptr;
+	bool allocationFree = false;
+	std::atomic<uint64_t> count{};
+	std::atomic<uint64_t> bytes{};
+	std::atomic<uint64_t> frameCount{};
+	std::atomic<uint64_t> frameBytes{};
+	std::atomic<uint64_t> violations{};
+	// Totals for the last completed frame, and the worst frame seen
+	uint64_t lastFrameCount{};
+	uint64_t lastFrameBytes{};
+	uint64_t maxFrameCount{};
+};
+
+// Counts every call to the global operator new (replaced in AllocTracker.cpp)
+// and attributes it to the zone the allocating thread is currently in.
+// Allocations outside any zone land in zone 0, "Untracked".
+class AllocTracker
+{
+public:
+	// constexpr so the tracker is constant-initialized and safe to use from
+	// allocations made by other globals' constructors
+	constexpr AllocTracker()
+	{
+		m_Zones[0].name = "Untracked";
+		m_ZoneCount = 1;
+	}
+
+	void OnAllocate(size_t size)
+	{
+		m_TotalCount.fetch_add(1, std::memory_order_relaxed);
+		m_TotalBytes.fetch_add(size, std::memory_order_relaxed);
+
+		auto& zone = m_Zones[t_CurrentZone];
+		zone.count.fetch_add(1, std::memory_order_relaxed);
+		zone.bytes.fetch_add(size, std::memory_order_relaxed);
+		zone.frameCount.fetch_add(1, std::memory_order_relaxed);
+		zone.frameBytes.fetch_add(size, std::memory_order_relaxed);
+
+		if (zone.allocationFree && m_Checking)
+		{
+			// Reporting may allocate itself, so don't recurse into it
+			thread_local bool t_Reporting = false;
+			if (t_Reporting)
+				return;
+			t_Reporting = true;
+
+			if (zone.violations.fetch_add(1, std::memory_order_relaxed) == 0)
+			{
+				std::fprintf(stderr, "Allocation of %zu bytes inside allocation-free zone \"%s\"\n", size, zone.name);
+				assert(false && "Allocation inside allocation-free zone.");
+			}
+
+			t_Reporting = false;
+		}
+	}
+
+	// Flag allocations inside allocation-free zones. The first one per zone is
+	// printed, and in debug builds also asserts.
+	void SetChecking(bool checking)
+	{
+		m_Checking = checking;
+	}
+
+	uint64_t GetTotalCount() const
+	{
+		return m_TotalCount.load(std::memory_order_relaxed);
+	}
+
+	uint64_t GetTotalBytes() const
+	{
+		return m_TotalBytes.load(std::memory_order_relaxed);
+	}
+
+	// Zones are looked up by name pointer, so pass the same string literal every time.
+	// Only ever called from the main thread.
+	size_t FindOrAddZone(const char* name, bool allocationFree)
+	{
+		for (size_t zone = 1; zone < m_ZoneCount; zone++)
+		{
+			if (m_Zones[zone].name == name)
+				return zone;
+		}
+
+		if (m_ZoneCount == ALLOC_MAX_ZONES)
+			return 0;
+
+		m_Zones[m_ZoneCount].name = name;
+		m_Zones[m_ZoneCount].allocationFree = allocationFree;
+		return m_ZoneCount++;
+	}
+
+	size_t EnterZone(size_t zone)
+	{
+		size_t previous = t_CurrentZone;
+		t_CurrentZone = zone;
+		return previous;
+	}
+
+	void EndFrame()
+	{
+		m_Frames++;
+		for (size_t zone = 0; zone < m_ZoneCount; zone++)
+		{
+			auto& allocZone = m_Zones[zone];
+			allocZone.lastFrameCount = allocZone.frameCount.exchange(0, std::memory_order_relaxed);
+			allocZone.lastFrameBytes = allocZone.frameBytes.exchange(0, std::memory_order_relaxed);
+			allocZone.maxFrameCount = std::max(allocZone.maxFrameCount, allocZone.lastFrameCount);
+		}
+	}
+
+	size_t GetZoneCount() const
+	{
+		return m_ZoneCount;
+	}
+
+	const AllocZone& GetZone(size_t index) const
+	{
+		return m_Zones[index];
+	}
+
+	void WriteZonesJson(std::ostream& out) const
+	{
+		double frames = (double)std::max<uint64_t>(m_Frames, 1);
+		out << "[";
+		for (size_t zone = 0; zone < m_ZoneCount; zone++)
+		{
+			auto const& allocZone = m_Zones[zone];
+			out << (zone > 0 ? ", " : "") << "{ \"name\": \"" << allocZone.name << "\""
+				<< ", \"allocation_free\": " << (allocZone.allocationFree ? "true" : "false")
+				<< ", \"allocs_per_frame\": " << allocZone.count.load() / frames
+				<< ", \"bytes_per_frame\": " << allocZone.bytes.load() / frames
+				<< ", \"last_frame_allocs\": " << allocZone.lastFrameCount
+				<< ", \"max_frame_allocs\": " << allocZone.maxFrameCount
+				<< ", \"violations\": " << allocZone.violations.load() << " }";
+		}
+		out << "]";
+	}
+
+private:
+	std::array<AllocZone, ALLOC_MAX_ZONES> m_Zones{};
+
+	size_t m_ZoneCount{};
+
+	std::atomic<uint64_t> m_TotalCount{};
+
+	std::atomic<uint64_t> m_TotalBytes{};
+
+	uint64_t m_Frames{};
+
+	bool m_Checking = false;
+
+	static thread_local size_t t_CurrentZone;
+};
+
+extern AllocTracker g_AllocTracker;
+
+class AllocScope
+{
+public:
+	AllocScope(const char* name, bool allocationFree)
+		: m_Previous(g_AllocTracker.EnterZone(g_AllocTracker.FindOrAddZone(name, allocationFree)))
+	{}
+
+	~AllocScope()
+	{
+		g_AllocTracker.EnterZone(m_Previous);
+	}
+
+private:
+	size_t m_Previous;
+};
+
+#define ALLOC_CONCAT_INNER(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_INNER(a, b)
+
+// Attribute allocations in the enclosing scope to `name`
+#define ALLOC_SCOPE(name) AllocScope ALLOC_CONCAT(allocScope, __LINE__)(name, false)
+// As above, and flag any allocation when checking is enabled
+#define ALLOC_FREE_SCOPE(name) AllocScope ALLOC_CONCAT(allocScope, __LINE__)(name, true)
@@ -0,0 +1,720 @@
+/*
+	Microbenchmarks for the ECS core, results are written as JSON so runs
+	from different versions can be diffed.
+
+	g++ -o Benchmark Benchmark.cpp Systems.cpp AllocTracker.cpp -O2 -DOLC_PLATFORM_HEADLESS -DOLC_GFX_NULL -lpthread -lpng -std=c++20
+
+	./Benchmark [--out results.json]
+*/
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+#include "ECS.h"
+#include "Profiler.h"
+#include "AllocTracker.h"
+#include "CommandQueue.h"
+#include "Events.h"
+#include "StaticWorld.h"
+#include "SpatialGrid.h"
+#include "Systems.h"
+
+struct BenchmarkResult
+{
+	std::string name;
+	uint64_t operations;
+	double nsPerOp;
+	double allocationsPerOp;
+	PerfCounterValues counters;
+};
+
+std::vector<BenchmarkResult> g_Results;
+// Already formatted JSON objects with per-system breakdowns
+std::vector<std::string> g_FrameResults;
+
+// Times a single run of body, which must perform exactly `operations` operations
+template<typename F>
+void Measure(const std::string& name, uint64_t operations, F&& body)
+{
+	PerfCounters perfCounters;
+	perfCounters.Enable();
+
+	uint64_t allocationsBefore = g_AllocTracker.GetTotalCount();
+	PerfCounterValues countersBefore = perfCounters.Read();
+	auto start = std::chrono::steady_clock::now();
+
+	body();
+
+	auto end = std::chrono::steady_clock::now();
+	PerfCounterValues counters = perfCounters.Read();
+	uint64_t allocations = g_AllocTracker.GetTotalCount() - allocationsBefore;
+
+	for (size_t counter = 0; counter < PERF_COUNTER_COUNT; counter++)
+	{
+		if (counters[counter] >= 0 && countersBefore[counter] >= 0)
+			counters[counter] -= countersBefore[counter];
+		else
+			counters[counter] = -1;
+	}
+
+	double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	g_Results.push_back({ name, operations, ns / operations, (double)allocations / operations, counters });
+}
+
+// Keeps the optimiser from discarding results that are never read
+template<typename T>
+void DoNotOptimize(T const& value)
+{
+#if defined(__GNUC__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile T sink;
+	sink = value;
+#endif
+}
+
+void BenchEntityChurn()
+{
+	const uint32_t rounds = 100;
+	const uint32_t batch = 1000;
+	auto entityManager = std::make_unique<EntityManager>();
+	std::vector<Entity> entities(batch);
+
+	Measure("EntityManager::CreateEntity+DestroyEntity", rounds * batch * 2, [&]()
+	{
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			for (uint32_t i = 0; i < batch; i++)
+				entities[i] = entityManager->CreateEntity();
+			for (uint32_t i = 0; i < batch; i++)
+				entityManager->DestroyEntity(entities[i]);
+		}
+	});
+}
+
+void BenchComponentArray()
+{
+	const uint32_t rounds = 20;
+	auto components = std::make_unique<ComponentArray<Transform>>();
+
+	Measure("ComponentArray::InsertData", MAX_ENTITIES, [&]()
+	{
+		for (Entity entity = 0; entity < MAX_ENTITIES; entity++)
+			components->InsertData(entity, Transform{ .position = olc::vf2d((float)entity, 0.0f) });
+	});
+
+	Measure("ComponentArray::GetData", rounds * MAX_ENTITIES, [&]()
+	{
+		float sum = 0.0f;
+		for (uint32_t round = 0; round < rounds; round++)
+			for (Entity entity = 0; entity < MAX_ENTITIES; entity++)
+				sum += components->GetData(entity).position.x;
+		DoNotOptimize(sum);
+	});
+
+	Measure("ComponentArray::RemoveData", MAX_ENTITIES, [&]()
+	{
+		for (Entity entity = 0; entity < MAX_ENTITIES; entity++)
+			components->RemoveData(entity);
+	});
+}
+
+void BenchQuery()
+{
+	const uint32_t rounds = 100;
+	auto entityManager = std::make_unique<EntityManager>();
+
+	// Every entity has component 0, every other one also has component 1
+	for (Entity i = 0; i < MAX_ENTITIES; i++)
+	{
+		Entity entity = entityManager->CreateEntity();
+		Signature signature;
+		signature.set(0);
+		signature.set(1, entity % 2 == 0);
+		entityManager->SetSignature(entity, signature);
+	}
+
+	SystemFilter filter;
+	filter.all.set(0);
+	filter.none.set(1);
+
+	std::vector<Entity> matches;
+	matches.reserve(MAX_ENTITIES);
+	Measure("EntityManager::Query/signature_bits:" + std::to_string(MAX_COMPONENTS), rounds * MAX_ENTITIES, [&]()
+	{
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			matches.clear();
+			entityManager->Query(filter, matches);
+			DoNotOptimize(matches.data());
+		}
+	});
+}
+
+template<size_t I>
+class BenchSystem : public System
+{};
+
+template<size_t... I>
+void RegisterBenchSystems(SystemManager& systemManager, std::index_sequence<I...>)
+{
+	Signature signature;
+	signature.set(0);
+	(systemManager.RegisterSystem<BenchSystem<I>>(), ...);
+	(systemManager.SetSignature<BenchSystem<I>>(signature), ...);
+}
+
+template<size_t N>
+void BenchSignatureChanged()
+{
+	const uint32_t rounds = 10;
+	auto systemManager = std::make_unique<SystemManager>();
+	RegisterBenchSystems(*systemManager, std::make_index_sequence<N>());
+
+	Signature matching;
+	matching.set(0);
+	Signature other;
+	other.set(1);
+
+	Measure("SystemManager::EntitySignatureChanged/systems:" + std::to_string(N), rounds * MAX_ENTITIES * 2, [&]()
+	{
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			for (Entity entity = 0; entity < MAX_ENTITIES; entity++)
+				systemManager->EntitySignatureChanged(entity, matching);
+			for (Entity entity = 0; entity < MAX_ENTITIES; entity++)
+				systemManager->EntitySignatureChanged(entity, other);
+		}
+	});
+}
+
+struct GameSystems
+{
+	std::shared_ptr<RenderSystem> render;
+	std::shared_ptr<CollisionSystem> collision;
+	std::shared_ptr<BulletSystem> bullet;
+	std::shared_ptr<AISystem> ai;
+};
+
+// Registers the shipped component and system set on the given coordinator
+GameSystems RegisterGameTypes(Coordinator& coordinator)
+{
+	coordinator.Init();
+
+	coordinator.RegisterComponent<Gravity>("Gravity");
+	coordinator.RegisterComponent<RigidBody>("RigidBody");
+	coordinator.RegisterComponent<Transform>("Transform");
+	coordinator.RegisterComponent<Graphic>("Graphic");
+	coordinator.RegisterComponent<Input>("Input");
+	coordinator.RegisterComponent<Collision>("Collision");
+	coordinator.RegisterComponent<Bullet>("Bullet");
+	coordinator.RegisterComponent<AI>("AI");
+
+	GameSystems systems;
+	coordinator.RegisterSystem<PhysicsSystem>();
+	systems.render = coordinator.RegisterSystem<RenderSystem>();
+	coordinator.RegisterSystem<MovementSystem>();
+	systems.collision = coordinator.RegisterSystem<CollisionSystem>();
+	systems.bullet = coordinator.RegisterSystem<BulletSystem>();
+	systems.ai = coordinator.RegisterSystem<AISystem>();
+
+	Signature signature;
+	signature.set(coordinator.GetComponentType<Gravity>());
+	signature.set(coordinator.GetComponentType<RigidBody>());
+	signature.set(coordinator.GetComponentType<Transform>());
+	coordinator.SetSystemSignature<PhysicsSystem>(signature);
+
+	signature.reset();
+	signature.set(coordinator.GetComponentType<Transform>());
+	signature.set(coordinator.GetComponentType<Graphic>());
+	signature.set(coordinator.GetComponentType<Collision>());
+	coordinator.SetSystemSignature<RenderSystem>(signature);
+
+	signature.reset();
+	signature.set(coordinator.GetComponentType<Transform>());
+	signature.set(coordinator.GetComponentType<Input>());
+	signature.set(coordinator.GetComponentType<Collision>());
+	coordinator.SetSystemSignature<MovementSystem>(signature);
+
+	signature.reset();
+	signature.set(coordinator.GetComponentType<Transform>());
+	signature.set(coordinator.GetComponentType<Collision>());
+	coordinator.SetSystemSignature<CollisionSystem>(signature);
+
+	signature.reset();
+	signature.set(coordinator.GetComponentType<Transform>());
+	signature.set(coordinator.GetComponentType<Collision>());
+	signature.set(coordinator.GetComponentType<Bullet>());
+	coordinator.SetSystemSignature<BulletSystem>(signature);
+
+	signature.reset();
+	signature.set(coordinator.GetComponentType<Transform>());
+	signature.set(coordinator.GetComponentType<Collision>());
+	signature.set(coordinator.GetComponentType<AI>());
+	coordinator.SetSystemSignature<AISystem>(signature);
+
+	TrackSpatialIndex(coordinator, systems.collision->m_Grid);
+
+	return systems;
+}
+
+// The pools are sized for MAX_ENTITIES, so coordinators live on the heap
+std::unique_ptr<Coordinator> MakeGameCoordinator()
+{
+	auto coordinator = std::make_unique<Coordinator>();
+	RegisterGameTypes(*coordinator);
+	return coordinator;
+}
+
+// Fills the coordinator with MAX_ENTITIES entities, `addComponents` gives each one its components
+template<typename F>
+std::vector<Entity> CreateEntities(Coordinator& coordinator, F&& addComponents)
+{
+	std::vector<Entity> entities(MAX_ENTITIES);
+	for (auto& entity : entities)
+	{
+		entity = coordinator.CreateEntity();
+		addComponents(entity);
+	}
+	return entities;
+}
+
+// Same component set as an enemy, every add re-evaluates all six systems
+void AddEnemyComponents(Coordinator& coordinator, Entity entity)
+{
+	coordinator.AddComponent(entity, Transform{ .position = olc::vf2d((float)entity, 0.0f) });
+	coordinator.AddComponent(entity, Graphic{ .tint = olc::WHITE });
+	coordinator.AddComponent(entity, AI{ .velocity = olc::vf2d(0.0f, 50.0f), .shootInterval = 2.0f });
+	coordinator.AddComponent(entity, Collision{ .radius = 6.0f });
+}
+
+void BenchAddComponent()
+{
+	auto coordinator = MakeGameCoordinator();
+	auto entities = CreateEntities(*coordinator, [](Entity) {});
+
+	Measure("Coordinator::AddComponent/enemy", MAX_ENTITIES * 4, [&]()
+	{
+		for (auto const& entity : entities)
+			AddEnemyComponents(*coordinator, entity);
+	});
+}
+
+// Observers only queue entities, the callbacks run once per batch at the flush
+void BenchObservers()
+{
+	auto coordinator = MakeGameCoordinator();
+
+	size_t added = 0;
+	size_t removed = 0;
+	coordinator->OnAdd<Transform>([&](std::span<const Entity> entities) { added += entities.size(); });
+	coordinator->OnRemove<Transform>([&](std::span<const Entity> entities) { removed += entities.size(); });
+
+	auto entities = CreateEntities(*coordinator, [](Entity) {});
+
+	Measure("Coordinator::AddComponent+FlushObservers/observed", MAX_ENTITIES, [&]()
+	{
+		for (auto const& entity : entities)
+			coordinator->AddComponent(entity, Transform{ .position = olc::vf2d((float)entity, 0.0f) });
+		coordinator->FlushObservers();
+	});
+
+	Measure("Coordinator::RemoveComponent+FlushObservers/observed", MAX_ENTITIES, [&]()
+	{
+		for (auto const& entity : entities)
+			coordinator->RemoveComponent<Transform>(entity);
+		coordinator->FlushObservers();
+	});
+
+	DoNotOptimize(added + removed);
+}
+
+void BenchDestroyEntity()
+{
+	auto coordinator = MakeGameCoordinator();
+	auto addEnemy = [&](Entity entity) { AddEnemyComponents(*coordinator, entity); };
+
+	auto entities = CreateEntities(*coordinator, addEnemy);
+	Measure("Coordinator::DestroyEntity/enemy", MAX_ENTITIES, [&]()
+	{
+		for (auto const& entity : entities)
+			coordinator->DestroyEntity(entity);
+	});
+
+	entities = CreateEntities(*coordinator, addEnemy);
+	Measure("Coordinator::DestroyEntities/enemy", MAX_ENTITIES, [&]()
+	{
+		coordinator->DestroyEntities(entities);
+	});
+}
+
+// Only every tenth Transform is written each tick, the query should cost a
+// scan of the pool's ticks rather than a visit to every entity
+void BenchChangeQuery()
+{
+	const uint32_t rounds = 100;
+	auto coordinator = MakeGameCoordinator();
+	auto entities = CreateEntities(*coordinator, [&](Entity entity)
+	{
+		coordinator->AddComponent(entity, Transform{ .position = olc::vf2d((float)entity, 0.0f) });
+	});
+
+	std::vector<Entity> changed;
+	changed.reserve(MAX_ENTITIES);
+	Measure("Coordinator::Query<Changed>/one_in_ten", rounds * MAX_ENTITIES, [&]()
+	{
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			Tick since = coordinator->GetTick();
+			coordinator->AdvanceTick();
+			for (Entity i = round % 10; i < MAX_ENTITIES; i += 10)
+				coordinator->GetComponent<Transform>(entities[i]).position.y += 1.0f;
+
+			changed.clear();
+			coordinator->Query<Changed<Transform>>(since, changed);
+			DoNotOptimize(changed.size());
+		}
+	});
+}
+
+// Writing every Collision and committing the pool when the tick advances
+void BenchDoubleBuffer()
+{
+	const uint32_t rounds = 100;
+	auto coordinator = MakeGameCoordinator();
+	auto entities = CreateEntities(*coordinator, [&](Entity entity)
+	{
+		coordinator->AddComponent(entity, Collision{ .radius = 6.0f });
+	});
+
+	Measure("Coordinator::AdvanceTick/commit_collision", rounds * MAX_ENTITIES, [&]()
+	{
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			for (auto const& entity : entities)
+				coordinator->GetComponent<Collision>(entity).isCollision = (entity + round) % 2;
+			coordinator->AdvanceTick();
+			DoNotOptimize(coordinator->ReadComponent<Collision>(round).isCollision);
+		}
+	});
+}
+
+// Spawns through reserved IDs and the command queue, then destroys the same way
+void BenchCommandQueue()
+{
+	auto coordinator = MakeGameCoordinator();
+	auto commands = std::make_unique<CommandQueue>();
+
+	Measure("CommandQueue::Spawn+Apply/bullet", MAX_ENTITIES, [&]()
+	{
+		for (Entity i = 0; i < MAX_ENTITIES; i++)
+		{
+			Entity entity = coordinator->ReserveEntity();
+			commands->Spawn(entity,
+							Transform{ .position = olc::vf2d((float)i, 0.0f) },
+							Bullet{ .velocity = olc::vf2d(0.0f, 100.0f) },
+							Collision{ .radius = 2.0f });
+		}
+		commands->Apply(*coordinator);
+	});
+
+	Measure("CommandQueue::Destroy+Apply/bullet", MAX_ENTITIES, [&]()
+	{
+		for (Entity entity = 0; entity < MAX_ENTITIES; entity++)
+			commands->Destroy(entity);
+		commands->Apply(*coordinator);
+	});
+}
+
+void BenchLateRegistration()
+{
+	auto coordinator = MakeGameCoordinator();
+	CreateEntities(*coordinator, [&](Entity entity)
+	{
+		coordinator->AddComponent(entity, Transform{ .position = olc::vf2d((float)entity, 0.0f) });
+		coordinator->AddComponent(entity, Collision{ .radius = 6.0f });
+		if (entity % 2 == 0)
+			coordinator->AddComponent(entity, Bullet{});
+	});
+
+	Signature signature;
+	signature.set(coordinator->GetComponentType<Transform>());
+	signature.set(coordinator->GetComponentType<Bullet>());
+
+	// Attaching a system to a full world back-fills it with every matching entity
+	Measure("Coordinator::RegisterSystem+SetSystemSignature/full_world", MAX_ENTITIES, [&]()
+	{
+		coordinator->RegisterSystem<BenchSystem<1000>>();
+		coordinator->SetSystemSignature<BenchSystem<1000>>(signature);
+	});
+}
+
+// The same enemy move and destroy loop through the Coordinator and through a
+// StaticWorld, where every lookup is resolved at compile time
+struct StaticMoveSystem
+{
+	using Components = ComponentList<Transform, AI>;
+};
+
+using StaticEnemyWorld = StaticWorld<ComponentList<Transform, Graphic, AI, Collision, Bullet, Input>, SystemList<StaticMoveSystem>>;
+
+void BenchStaticWorld()
+{
+	const uint32_t rounds = 100;
+	const float deltaTime = 1.0f / 60.0f;
+
+	auto coordinator = std::make_unique<Coordinator>();
+	auto aiSystem = RegisterGameTypes(*coordinator).ai;
+	auto world = std::make_unique<StaticEnemyWorld>();
+
+	std::vector<Entity> entities(MAX_ENTITIES);
+	std::vector<Entity> staticEntities(MAX_ENTITIES);
+	for (Entity i = 0; i < MAX_ENTITIES; i++)
+	{
+		Transform transform{ .position = olc::vf2d((float)i, 0.0f) };
+		AI ai{ .velocity = olc::vf2d(0.0f, 50.0f), .shootInterval = 2.0f };
+
+		entities[i] = coordinator->CreateEntity();
+		coordinator->AddComponent(entities[i], transform);
+		coordinator->AddComponent(entities[i], ai);
+		coordinator->AddComponent(entities[i], Collision{ .radius = 6.0f });
+
+		staticEntities[i] = world->CreateEntity();
+		world->AddComponent(staticEntities[i], transform);
+		world->AddComponent(staticEntities[i], ai);
+		world->AddComponent(staticEntities[i], Collision{ .radius = 6.0f });
+	}
+
+	Measure("Coordinator::GetComponent/move", rounds * MAX_ENTITIES, [&]()
+	{
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			for (auto const& entity : aiSystem->m_Entities)
+			{
+				auto& transform = coordinator->GetComponent<Transform>(entity);
+				auto const& ai = coordinator->GetComponent<AI>(entity);
+				transform.position += ai.velocity * deltaTime;
+			}
+		}
+	});
+
+	Measure("StaticWorld::ForEach/move", rounds * MAX_ENTITIES, [&]()
+	{
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			world->ForEach<StaticMoveSystem>([&](Entity, Transform& transform, AI const& ai)
+			{
+				transform.position += ai.velocity * deltaTime;
+			});
+		}
+	});
+
+	Measure("Coordinator::DestroyEntity/move", MAX_ENTITIES, [&]()
+	{
+		for (auto const& entity : entities)
+			coordinator->DestroyEntity(entity);
+	});
+
+	Measure("StaticWorld::DestroyEntity/move", MAX_ENTITIES, [&]()
+	{
+		for (auto const& entity : staticEntities)
+			world->DestroyEntity(entity);
+	});
+}
+
+// Moves inside a cell only compare cell keys, crossing a cell relinks the entity
+void BenchSpatialGrid()
+{
+	const uint32_t rounds = 100;
+	auto grid = std::make_unique<SpatialGrid>();
+
+	std::vector<olc::vf2d> positions(MAX_ENTITIES);
+	for (Entity entity = 0; entity < MAX_ENTITIES; entity++)
+	{
+		positions[entity] = olc::vf2d((float)(entity % 64), (float)(entity / 64)) * SPATIAL_CELL_SIZE;
+		grid->Insert(entity, positions[entity], 6.0f);
+	}
+
+	Measure("SpatialGrid::Move/sub_cell", rounds * MAX_ENTITIES, [&]()
+	{
+		for (uint32_t round = 0; round < rounds; round++)
+			for (Entity entity = 0; entity < MAX_ENTITIES; entity++)
+				grid->Move(entity, positions[entity] + olc::vf2d(0.0f, (float)(round % 8)));
+	});
+
+	Measure("SpatialGrid::Move/cross_cell", rounds * MAX_ENTITIES, [&]()
+	{
+		for (uint32_t round = 0; round < rounds; round++)
+			for (Entity entity = 0; entity < MAX_ENTITIES; entity++)
+				grid->Move(entity, positions[entity] + olc::vf2d(0.0f, (float)(round % 2) * SPATIAL_CELL_SIZE));
+	});
+}
+
+void BenchCheckAllCollision(uint32_t entityCount)
+{
+	auto collisionSystem = RegisterGameTypes(g_Coordinator).collision;
+
+	// Spread out so nothing overlaps and the pass never stops early. Every
+	// entity still queries its neighbouring cells and finds others to test.
+	uint32_t columns = (uint32_t)std::ceil(std::sqrt((float)entityCount));
+	for (uint32_t i = 0; i < entityCount; i++)
+	{
+		Entity entity = g_Coordinator.CreateEntity();
+		g_Coordinator.AddComponent(entity, Transform{ .position = olc::vf2d((float)(i % columns), (float)(i / columns)) * 20.0f });
+		g_Coordinator.AddComponent(entity, Collision{ .radius = 6.0f });
+	}
+	g_Coordinator.FlushObservers();
+
+	// Each entity costs about the same whatever the count, so the total work is kept level
+	uint32_t frames = std::max(1u, 2000000u / entityCount);
+	Measure("CollisionSystem::CheckAllCollision/entities:" + std::to_string(entityCount), frames, [&]()
+	{
+		for (uint32_t frame = 0; frame < frames; frame++)
+			collisionSystem->CheckAllCollision();
+	});
+}
+
+// Runs the enemy and bullet systems for a number of 60 Hz frames and reports
+// time and hardware counters per system and per frame
+void BenchFrame(olc::PixelGameEngine& engine, ResourceHandle decal, uint32_t enemyCount)
+{
+	const uint32_t frames = 60;
+	const float deltaTime = 1.0f / 60.0f;
+
+	auto systems = RegisterGameTypes(g_Coordinator);
+
+	// Enemies start on a grid so they do not destroy each other straight away,
+	// with staggered shoot timers so bullets are spread over the frames
+	for (uint32_t i = 0; i < enemyCount; i++)
+	{
+		Entity entity = g_Coordinator.CreateEntity();
+		g_Coordinator.AddComponent(entity, Transform{ .position = olc::vf2d((float)(i % 16), (float)(i / 16)) * 16.0f, .scale = olc::vf2d(1.0f, 1.0f) });
+		g_Coordinator.AddComponent(entity, Graphic{ .decal = decal, .tint = olc::WHITE });
+		g_Coordinator.AddComponent(entity, AI{ .velocity = olc::vf2d(0.0f, 50.0f), .shootInterval = 2.0f, .shootTimer = 2.0f * i / enemyCount, .bulletDecal = decal });
+		g_Coordinator.AddComponent(entity, Collision{ .radius = 6.0f });
+	}
+	g_Coordinator.FlushObservers();
+
+	g_PerfCounters.Enable();
+	g_PerfCounters.ResetZones();
+
+	for (uint32_t frame = 0; frame < frames; frame++)
+	{
+		PROFILE_SCOPE("Frame");
+		{
+			PROFILE_SCOPE("Render");
+			systems.render->Render(&engine);
+		}
+		{
+			PROFILE_SCOPE("MoveBullet");
+			systems.bullet->MoveBullet(deltaTime, &engine);
+		}
+		{
+			PROFILE_SCOPE("Move");
+			systems.ai->Move(deltaTime, &engine);
+		}
+		{
+			PROFILE_SCOPE("Collision");
+			systems.collision->Update();
+			systems.bullet->ResolveHits();
+			systems.ai->ResolveHits();
+		}
+		{
+			PROFILE_SCOPE("Shoot");
+			systems.ai->Shoot(deltaTime);
+			systems.bullet->SpawnBullets();
+		}
+		{
+			PROFILE_SCOPE("ApplyCommands");
+			g_Commands.Apply(g_Coordinator);
+		}
+		g_Events.Clear();
+		g_Coordinator.FlushObservers();
+		g_Coordinator.AdvanceTick();
+		g_PerfCounters.EndFrame();
+	}
+
+	std::ostringstream json;
+	json << "{ \"name\": \"Frame/enemies:" << enemyCount << "\", \"frames\": " << frames << ", \"systems\": ";
+	g_PerfCounters.WriteZonesJson(json);
+	json << " }";
+	g_FrameResults.push_back(json.str());
+
+	g_PerfCounters.Disable();
+}
+
+int main(int argc, char* argv[])
+{
+	std::string outPath;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--out" && i + 1 < argc)
+		{
+			outPath = argv[++i];
+		}
+	}
+
+	BenchEntityChurn();
+	BenchComponentArray();
+	BenchQuery();
+	BenchSignatureChanged<1>();
+	BenchSignatureChanged<8>();
+	BenchSignatureChanged<32>();
+	BenchAddComponent();
+	BenchObservers();
+	BenchDestroyEntity();
+	BenchChangeQuery();
+	BenchDoubleBuffer();
+	BenchCommandQueue();
+	BenchLateRegistration();
+	BenchStaticWorld();
+	BenchSpatialGrid();
+	for (uint32_t entityCount : { 100u, 1000u, 5000u })
+		BenchCheckAllCollision(entityCount);
+
+	// The render and AI systems need a live, if invisible, engine to draw into
+	olc::PixelGameEngine engine;
+	engine.Construct(256, 240, 1, 1);
+	engine.olc_PrepareEngine();
+	ResourceHandle decal = g_Resources.AddDecal(std::make_unique<olc::Sprite>(8, 8));
+	for (uint32_t enemyCount : { 100u, 1000u })
+		BenchFrame(engine, decal, enemyCount);
+	g_Resources.Clear();
+
+	std::ostringstream json;
+	json << "{\n\t\"max_entities\": " << MAX_ENTITIES << ",\n\t\"benchmarks\": [\n";
+	for (size_t i = 0; i < g_Results.size(); i++)
+	{
+		auto const& result = g_Results[i];
+		json << "\t\t{ \"name\": \"" << result.name << "\""
+			<< ", \"operations\": " << result.operations
+			<< ", \"ns_per_op\": " << result.nsPerOp
+			<< ", \"allocs_per_op\": " << result.allocationsPerOp;
+		for (size_t counter = 0; counter < PERF_COUNTER_COUNT; counter++)
+		{
+			json << ", \"" << PERF_COUNTER_NAMES[counter] << "_per_op\": ";
+			if (result.counters[counter] < 0)
+				json << "null";
+			else
+				json << (double)result.counters[counter] / result.operations;
+		}
+		json << " }" << (i + 1 < g_Results.size() ? "," : "") << "\n";
+	}
+	json << "\t],\n\t\"frames\": [\n";
+	for (size_t i = 0; i < g_FrameResults.size(); i++)
+	{
+		json << "\t\t" << g_FrameResults[i] << (i + 1 < g_FrameResults.size() ? "," : "") << "\n";
+	}
+	json << "\t]\n}\n";
+
+	if (outPath.empty())
+	{
+		std::cout << json.str();
+	}
+	else
+	{
+		std::ofstream file(outPath);
+		file << json.str();
+	}
+
+	return 0;
+}
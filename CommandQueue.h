@@ -0,0 +1,197 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "ECS.h"
+
+// Components are copied into the command as raw bytes, so everything a spawn carries must fit here
+const size_t COMMAND_PAYLOAD_BYTES = 96;
+// Every ID spawned once plus every entity destroyed twice in the same frame
+const size_t COMMAND_CAPACITY = 16384;
+static_assert((COMMAND_CAPACITY & (COMMAND_CAPACITY - 1)) == 0, "COMMAND_CAPACITY must be a power of two.");
+static_assert(COMMAND_CAPACITY >= MAX_ENTITIES * 3, "COMMAND_CAPACITY too small for MAX_ENTITIES.");
+
+// Spawn and destroy requests from any number of threads, applied by one.
+// Bounded and lock-free: producers claim a slot with a compare-exchange on the
+// tail and publish it through the slot's sequence number, the consumer pops in
+// order and hands the slot back by bumping the sequence a lap ahead.
+//
+// Entity IDs for spawns come from Coordinator::ReserveEntity, which is also
+// safe on worker threads, so a producer can refer to the new entity at once.
+class CommandQueue
+{
+public:
+	CommandQueue()
+		: m_Slots(std::make_unique<Slot[]>(COMMAND_CAPACITY))
+	{
+		for (size_t index = 0; index < COMMAND_CAPACITY; index++)
+		{
+			m_Slots[index].sequence.store(index, std::memory_order_relaxed);
+		}
+		m_Destroyed.reserve(MAX_ENTITIES);
+	}
+
+	// Gives a reserved entity its components when the queue is applied
+	template<typename... Ts>
+	bool Spawn(Entity entity, const Ts&... components)
+	{
+		static_assert(sizeof...(Ts) > 0, "Spawn needs at least one component.");
+		static_assert((std::is_trivially_copyable_v<Ts> && ...), "Spawned components must be trivially copyable.");
+		static_assert(((alignof(Ts) <= alignof(std::max_align_t)) && ...), "Spawned component over-aligned.");
+		static_assert(PayloadSize<Ts...>() <= COMMAND_PAYLOAD_BYTES, "Spawn payload too large, raise COMMAND_PAYLOAD_BYTES.");
+
+		alignas(std::max_align_t) std::byte payload[PayloadSize<Ts...>()];
+		size_t offset = 0;
+		((offset = AlignUp(offset, alignof(Ts)), std::memcpy(payload + offset, &components, sizeof(Ts)), offset += sizeof(Ts)), ...);
+
+		return Push(entity, &ApplySpawn<Ts...>, payload, sizeof(payload));
+	}
+
+	// Destroying the same entity more than once before the queue is applied is fine
+	bool Destroy(Entity entity)
+	{
+		return Push(entity, nullptr, nullptr, 0);
+	}
+
+	// Main thread only, at the frame's sync point. Spawns are applied in the
+	// order they were pushed, then every destroyed entity goes in one batch.
+	void Apply(Coordinator& coordinator)
+	{
+		m_Destroyed.clear();
+
+		uint64_t head = m_Head;
+		for (;;)
+		{
+			Slot& slot = m_Slots[head & (COMMAND_CAPACITY - 1)];
+			if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+				break;
+
+			Command& command = slot.command;
+			if (command.apply)
+			{
+				command.apply(coordinator, command.entity, command.payload);
+			}
+			else
+			{
+				m_Destroyed.push_back(command.entity);
+			}
+
+			slot.sequence.store(head + COMMAND_CAPACITY, std::memory_order_release);
+			++head;
+		}
+		m_Head = head;
+
+		std::sort(m_Destroyed.begin(), m_Destroyed.end());
+		m_Destroyed.erase(std::unique(m_Destroyed.begin(), m_Destroyed.end()), m_Destroyed.end());
+		coordinator.DestroyEntities(m_Destroyed);
+	}
+
+	uint64_t GetDropped() const
+	{
+		return m_Dropped.load(std::memory_order_relaxed);
+	}
+
+private:
+	using ApplyFunction = void (*)(Coordinator&, Entity, const std::byte*);
+
+	struct Command
+	{
+		// nullptr for a destroy
+		ApplyFunction apply;
+		Entity entity;
+		alignas(std::max_align_t) std::byte payload[COMMAND_PAYLOAD_BYTES];
+	};
+
+	struct Slot
+	{
+		std::atomic<uint64_t> sequence;
+		Command command;
+	};
+
+	std::unique_ptr<Slot[]> m_Slots;
+
+	// Producers and the consumer each get their own cache line
+	alignas(64) std::atomic<uint64_t> m_Tail{};
+
+	alignas(64) uint64_t m_Head{};
+
+	std::atomic<uint64_t> m_Dropped{};
+
+	// Reused by Apply so destroying doesn't allocate
+	std::vector<Entity> m_Destroyed;
+
+	bool Push(Entity entity, ApplyFunction apply, const void* payload, size_t size)
+	{
+		uint64_t tail = m_Tail.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Slot& slot = m_Slots[tail & (COMMAND_CAPACITY - 1)];
+			uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+			if (sequence == tail)
+			{
+				// The slot is free for this lap, claim it
+				if (m_Tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+				{
+					slot.command.apply = apply;
+					slot.command.entity = entity;
+					if (size > 0)
+					{
+						std::memcpy(slot.command.payload, payload, size);
+					}
+					slot.sequence.store(tail + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (sequence < tail)
+			{
+				// The consumer hasn't freed this slot since the last lap, so the queue is full
+				m_Dropped.fetch_add(1, std::memory_order_relaxed);
+				assert(false && "Command queue full.");
+				return false;
+			}
+			else
+			{
+				tail = m_Tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	static constexpr size_t AlignUp(size_t offset, size_t alignment)
+	{
+		return (offset + alignment - 1) & ~(alignment - 1);
+	}
+
+	// Components are packed back to back, each at its own alignment
+	template<typename... Ts>
+	static constexpr size_t PayloadSize()
+	{
+		size_t offset = 0;
+		((offset = AlignUp(offset, alignof(Ts)) + sizeof(Ts)), ...);
+		return offset;
+	}
+
+	template<typename... Ts>
+	static void ApplySpawn(Coordinator& coordinator, Entity entity, const std::byte* payload)
+	{
+		size_t offset = 0;
+		auto addComponent = [&]<typename T>()
+		{
+			offset = AlignUp(offset, alignof(T));
+			T component;
+			std::memcpy(&component, payload + offset, sizeof(T));
+			offset += sizeof(T);
+			coordinator.AddComponent(entity, component);
+		};
+		(addComponent.template operator()<Ts>(), ...);
+	}
+};
+
+extern CommandQueue g_Commands;
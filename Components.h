@@ -1,5 +1,7 @@
 #pragma once
-#include <memory>
+#include <type_traits>
+
+#include "Resources.h"
 
 struct Transform
 {
@@ -21,7 +23,7 @@ struct RigidBody
 
 struct Graphic
 {
-	std::shared_ptr<olc::Decal> decal;
+	ResourceHandle decal;
 	olc::Pixel tint;
 };
 
@@ -30,8 +32,11 @@ struct Input
 	float speed;
 };
 
+// Render reads last tick's hits while the collision pass writes this tick's
 struct Collision
 {
+	static constexpr bool DOUBLE_BUFFERED = true;
+
 	float radius;
 	olc::vf2d center;
 	bool isCollision;
@@ -46,5 +51,17 @@ struct AI
 {
 	olc::vf2d velocity;
 	float shootInterval;
+	float bulletSpeed;
 	float shootTimer;
-};
\ No newline at end of file
+	ResourceHandle bulletDecal;
+};
+
+// Pools move components around with plain copies, keep them that way
+static_assert(std::is_trivially_copyable_v<Transform>);
+static_assert(std::is_trivially_copyable_v<Gravity>);
+static_assert(std::is_trivially_copyable_v<RigidBody>);
+static_assert(std::is_trivially_copyable_v<Graphic>);
+static_assert(std::is_trivially_copyable_v<Input>);
+static_assert(std::is_trivially_copyable_v<Collision>);
+static_assert(std::is_trivially_copyable_v<Bullet>);
+static_assert(std::is_trivially_copyable_v<AI>);
\ No newline at end of file
@@ -1,19 +1,161 @@
 #pragma once
 #include <iostream>
-#include <bitset>
-#include <queue>
+#include <atomic>
+#include <cstdint>
 #include <cassert>
 #include <array>
 #include <unordered_map>
 #include <set>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <memory>
+#include <type_traits>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define ECS_SIMD_SSE2
+	#include <emmintrin.h>
+#endif
 
 #include "Components.h"
 
 using Entity = std::uint32_t;
 const Entity MAX_ENTITIES = 5000;
+// Returned when no entity ID is free
+const Entity NULL_ENTITY = MAX_ENTITIES;
 using ComponentType = std::uint8_t;
-const ComponentType MAX_COMPONENTS = 500;
-using Signature = std::bitset<MAX_COMPONENTS>;
+
+// Signature width in bits, and so the number of component types: 64, 128 or 256
+#if !defined(ECS_SIGNATURE_BITS)
+	#define ECS_SIGNATURE_BITS 64
+#endif
+static_assert(ECS_SIGNATURE_BITS == 64 || ECS_SIGNATURE_BITS == 128 || ECS_SIGNATURE_BITS == 256, "ECS_SIGNATURE_BITS must be 64, 128 or 256.");
+const size_t MAX_COMPONENTS = ECS_SIGNATURE_BITS;
+
+// Debug builds assert when two threads write the same component pool at once, see PoolWriteScope
+#if !defined(ECS_RACE_DETECTION) && !defined(NDEBUG)
+	#define ECS_RACE_DETECTION
+#endif
+
+// Fixed width bit set over plain 64-bit words, the bitset subset the ECS uses.
+// An array of them is one flat run of words that can be scanned with SIMD.
+class Signature
+{
+public:
+	static constexpr size_t WORDS = MAX_COMPONENTS / 64;
+
+	constexpr Signature& set(size_t pos, bool value = true)
+	{
+		assert(pos < MAX_COMPONENTS && "Signature bit out of range.");
+
+		uint64_t bit = uint64_t(1) << (pos % 64);
+		m_Words[pos / 64] = value ? m_Words[pos / 64] | bit : m_Words[pos / 64] & ~bit;
+		return *this;
+	}
+
+	constexpr Signature& reset()
+	{
+		m_Words.fill(0);
+		return *this;
+	}
+
+	constexpr Signature& reset(size_t pos)
+	{
+		return set(pos, false);
+	}
+
+	constexpr bool test(size_t pos) const
+	{
+		assert(pos < MAX_COMPONENTS && "Signature bit out of range.");
+
+		return (m_Words[pos / 64] >> (pos % 64)) & 1;
+	}
+
+	constexpr bool any() const
+	{
+		for (uint64_t word : m_Words)
+			if (word != 0)
+				return true;
+		return false;
+	}
+
+	constexpr bool none() const
+	{
+		return !any();
+	}
+
+	constexpr Signature operator&(const Signature& other) const
+	{
+		Signature result;
+		for (size_t word = 0; word < WORDS; word++)
+			result.m_Words[word] = m_Words[word] & other.m_Words[word];
+		return result;
+	}
+
+	constexpr bool operator==(const Signature& other) const = default;
+
+	const uint64_t* data() const
+	{
+		return m_Words.data();
+	}
+
+private:
+	std::array<uint64_t, WORDS> m_Words{};
+};
+
+static_assert(sizeof(Signature) == Signature::WORDS * sizeof(uint64_t), "Signature arrays must pack into plain words.");
+
+// Which entities a system wants: every component in `all`, at least one
+// in `any` (ignored while empty) and none of the components in `none`
+struct SystemFilter
+{
+	Signature all;
+	Signature any;
+	Signature none;
+
+	constexpr bool Matches(const Signature& signature) const
+	{
+		return (signature & all) == all
+			&& (any.none() || (signature & any).any())
+			&& (signature & none).none();
+	}
+};
+
+// Counters are running totals, diff two snapshots to get rates
+struct PoolStats
+{
+	const char* name = nullptr;
+	ComponentType type{};
+	size_t size{};
+	size_t highWater{};
+	uint64_t inserts{};
+	uint64_t removes{};
+};
+
+struct SystemStats
+{
+	const char* name = nullptr;
+	size_t entities{};
+	uint64_t added{};
+	uint64_t removed{};
+};
+
+struct EcsStats
+{
+	uint32_t livingEntities{};
+	size_t freeEntities{};
+	uint32_t highWaterEntities{};
+	uint64_t signatureChanges{};
+	// Systems whose membership actually changed, summed over all signature changes
+	uint64_t systemsTouched{};
+	std::vector<PoolStats> pools;
+	std::vector<SystemStats> systems;
+};
 
 class EntityManager
 {
@@ -22,29 +164,52 @@ public:
 	{
 		for (Entity entity = 0; entity < MAX_ENTITIES; entity++)
 		{
-			m_AvailableEntities.push(entity);
+			m_AvailableEntities[entity] = entity;
 		}
+		m_FreeTail.store(MAX_ENTITIES, std::memory_order_relaxed);
 	}
 
 	Entity CreateEntity()
 	{
-		assert(m_LivingEntityCount < MAX_ENTITIES && "Too many entities in existence.");
+		assert(GetLivingEntityCount() < MAX_ENTITIES && "Too many entities in existence.");
+
+		return ReserveEntity();
+	}
+
+	// Takes the next free ID, or NULL_ENTITY when there is none. Lock-free and
+	// safe from any thread, alongside DestroyEntity on the main thread. The
+	// entity counts as living straight away and has no components yet.
+	Entity ReserveEntity()
+	{
+		uint64_t head = m_FreeHead.load(std::memory_order_relaxed);
+		Entity entity;
+		do
+		{
+			if (head == m_FreeTail.load(std::memory_order_acquire))
+				return NULL_ENTITY;
 
-		Entity id = m_AvailableEntities.front();
-		m_AvailableEntities.pop();
-		++m_LivingEntityCount;
+			entity = m_AvailableEntities[head % MAX_ENTITIES];
+		} while (!m_FreeHead.compare_exchange_weak(head, head + 1, std::memory_order_relaxed));
 
-		return id;
+		uint32_t living = GetLivingEntityCount();
+		uint32_t highWater = m_HighWaterEntityCount.load(std::memory_order_relaxed);
+		while (living > highWater && !m_HighWaterEntityCount.compare_exchange_weak(highWater, living, std::memory_order_relaxed))
+		{}
+
+		return entity;
 	}
 
+	// Main thread only
 	void DestroyEntity(Entity entity)
 	{
 		assert(entity < MAX_ENTITIES && "Entity out of range.");
 
 		m_Signatures[entity].reset();
 
-		m_AvailableEntities.push(entity);
-		--m_LivingEntityCount;
+		// Written before the tail moves past it, so a reserving thread never reads a stale ID
+		uint64_t tail = m_FreeTail.load(std::memory_order_relaxed);
+		m_AvailableEntities[tail % MAX_ENTITIES] = entity;
+		m_FreeTail.store(tail + 1, std::memory_order_release);
 	}
 
 	void SetSignature(Entity entity, Signature signature)
@@ -54,118 +219,657 @@ public:
 		m_Signatures[entity] = signature;
 	}
 
-	Signature GetSignature(Entity entity)
+	Signature GetSignature(Entity entity) const
 	{
 		assert(entity < MAX_ENTITIES && "Entity out of range.");
 
 		return m_Signatures[entity];
 	}
 
+	uint32_t GetLivingEntityCount() const
+	{
+		// Head first: the tail never falls behind a head we have already seen,
+		// but the head can move on before the tail is read, so clamp the gap
+		uint64_t head = m_FreeHead.load(std::memory_order_acquire);
+		uint64_t tail = m_FreeTail.load(std::memory_order_acquire);
+		uint64_t free = tail >= head ? std::min<uint64_t>(tail - head, MAX_ENTITIES) : 0;
+		return MAX_ENTITIES - (uint32_t)free;
+	}
+
+	// Appends every entity whose signature matches `filter` to `out`. Entities
+	// without components have an empty signature, the same as free IDs, and
+	// are never returned.
+	void Query(const SystemFilter& filter, std::vector<Entity>& out) const
+	{
+		Entity entity = 0;
+		bool needAny = filter.any.any();
+
+#if defined(ECS_SIMD_SSE2)
+		// Each 128-bit load is two words: two entities when signatures are one
+		// word, otherwise a slice of one entity's signature. A 64-bit lane is zero
+		// when all eight of its bytes compare equal to zero.
+		const uint64_t* words = m_Signatures[0].data();
+		const __m128i zero = _mm_setzero_si128();
+		auto isZero = [&](__m128i value) { return _mm_movemask_epi8(_mm_cmpeq_epi32(value, zero)); };
+
+		if constexpr (Signature::WORDS == 1)
+		{
+			const __m128i all = _mm_set1_epi64x((long long)filter.all.data()[0]);
+			const __m128i any = _mm_set1_epi64x((long long)filter.any.data()[0]);
+			const __m128i none = _mm_set1_epi64x((long long)filter.none.data()[0]);
+
+			for (; entity + 1 < MAX_ENTITIES; entity += 2)
+			{
+				__m128i signatures = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + entity));
+				// Required bits that are missing, and excluded bits that are present
+				int passed = isZero(_mm_or_si128(_mm_andnot_si128(signatures, all), _mm_and_si128(signatures, none)));
+				int missedAny = isZero(_mm_and_si128(signatures, any));
+				int empty = isZero(signatures);
+
+				for (int lane = 0; lane < 2; lane++)
+				{
+					int laneBits = 0xFF << (lane * 8);
+					if ((passed & laneBits) == laneBits && (empty & laneBits) != laneBits && (!needAny || (missedAny & laneBits) != laneBits))
+						out.push_back(entity + lane);
+				}
+			}
+		}
+		else
+		{
+			// Query isn't a template, so this branch is still compiled at one word
+			// and the arrays must not be zero-sized there
+			constexpr size_t SLICES = Signature::WORDS / 2;
+			__m128i all[std::max<size_t>(SLICES, 1)];
+			__m128i any[std::max<size_t>(SLICES, 1)];
+			__m128i none[std::max<size_t>(SLICES, 1)];
+			for (size_t slice = 0; slice < SLICES; slice++)
+			{
+				all[slice] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(filter.all.data() + slice * 2));
+				any[slice] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(filter.any.data() + slice * 2));
+				none[slice] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(filter.none.data() + slice * 2));
+			}
+
+			for (; entity < MAX_ENTITIES; entity++)
+			{
+				const uint64_t* signature = words + entity * Signature::WORDS;
+				__m128i failed = zero;
+				__m128i hit = zero;
+				__m128i bits = zero;
+				for (size_t slice = 0; slice < SLICES; slice++)
+				{
+					__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(signature + slice * 2));
+					failed = _mm_or_si128(failed, _mm_or_si128(_mm_andnot_si128(value, all[slice]), _mm_and_si128(value, none[slice])));
+					hit = _mm_or_si128(hit, _mm_and_si128(value, any[slice]));
+					bits = _mm_or_si128(bits, value);
+				}
+
+				if (isZero(failed) == 0xFFFF && isZero(bits) != 0xFFFF && (!needAny || isZero(hit) != 0xFFFF))
+					out.push_back(entity);
+			}
+		}
+#endif
+
+		for (; entity < MAX_ENTITIES; entity++)
+		{
+			auto const& signature = m_Signatures[entity];
+			if (signature.any() && filter.Matches(signature))
+				out.push_back(entity);
+		}
+	}
+
+	void GetStats(EcsStats& stats) const
+	{
+		stats.livingEntities = GetLivingEntityCount();
+		stats.freeEntities = MAX_ENTITIES - stats.livingEntities;
+		stats.highWaterEntities = m_HighWaterEntityCount.load(std::memory_order_relaxed);
+	}
+
 private:
-	std::queue<Entity> m_AvailableEntities{};
+	// Ring of free IDs, taken from the head and returned at the tail. The
+	// positions only ever grow, an ID's slot is its position modulo MAX_ENTITIES.
+	std::array<Entity, MAX_ENTITIES> m_AvailableEntities{};
+
+	std::atomic<uint64_t> m_FreeHead{};
+
+	std::atomic<uint64_t> m_FreeTail{};
 
 	std::array<Signature, MAX_ENTITIES> m_Signatures{};
 
-	uint32_t m_LivingEntityCount{};
+	std::atomic<uint32_t> m_HighWaterEntityCount{};
+};
+
+// Change ticks start at 1, so querying since tick 0 returns everything
+using Tick = std::uint32_t;
+
+// Filters for Coordinator::Query, matching entities whose T was changed,
+// added or removed after the tick passed in. Removals are kept for one
+// extra tick, so a system that runs every frame sees all of them.
+template<typename T>
+struct Changed
+{};
+
+template<typename T>
+struct Added
+{};
+
+template<typename T>
+struct Removed
+{};
+
+// Component events observers can subscribe to, in the order a flush reports them
+enum class ComponentEvent
+{
+	Remove,
+	Add,
+	Set,
+	Count
+};
+
+// Receives every entity the event happened to since the last flush, once each
+using ComponentObserver = std::function<void(std::span<const Entity>)>;
+
+// Component pools and threads:
+//  - ReadComponent and the queries only read, any number of threads may use
+//    them while nobody writes the entities they look at.
+//  - Different pools may be written by different threads at the same time.
+//  - One pool may be written through GetComponent by several threads at once
+//    if each writes its own entities, e.g. disjoint ranges of a system's
+//    members. A write only touches that entity's slot.
+//  - Adding, emplacing, setting and removing components and destroying
+//    entities reshape pools and queue observer events, so they stay on the
+//    main thread while no system runs.
+//  - In a double-buffered pool ReadComponent returns last tick's committed
+//    copy, which nobody writes, so it is safe alongside any writer.
+//
+// A system declares what it writes with Coordinator::WriteScope, and with
+// ECS_RACE_DETECTION an overlapping scope from another thread asserts.
+#if defined(ECS_RACE_DETECTION)
+class PoolWriteTracker
+{
+public:
+	// Entities [first, last) of the pool are written by this thread until End
+	void Begin(Entity first, Entity last)
+	{
+		std::lock_guard lock(m_Mutex);
+
+		auto thread = std::this_thread::get_id();
+		for (size_t index = 0; index < m_Count; index++)
+		{
+			auto const& writer = m_Writers[index];
+			bool overlaps = first < writer.last && writer.first < last;
+			assert((writer.thread == thread || !overlaps) && "Two systems write the same pool at the same time.");
+		}
+
+		assert(m_Count < m_Writers.size() && "Too many concurrent writers to one pool.");
+		m_Writers[m_Count++] = Writer{ thread, first, last };
+		m_Active.store(m_Count, std::memory_order_relaxed);
+	}
+
+	void End(Entity first, Entity last)
+	{
+		std::lock_guard lock(m_Mutex);
+
+		auto thread = std::this_thread::get_id();
+		for (size_t index = m_Count; index-- > 0;)
+		{
+			auto const& writer = m_Writers[index];
+			if (writer.thread == thread && writer.first == first && writer.last == last)
+			{
+				m_Writers[index] = m_Writers[--m_Count];
+				break;
+			}
+		}
+		m_Active.store(m_Count, std::memory_order_relaxed);
+	}
+
+	// Writing without a scope is fine until another thread opens one over the entity
+	void Check(Entity entity)
+	{
+		if (m_Active.load(std::memory_order_relaxed) == 0)
+			return;
+
+		std::lock_guard lock(m_Mutex);
+
+		auto thread = std::this_thread::get_id();
+		bool owned = false;
+		bool foreign = false;
+		for (size_t index = 0; index < m_Count; index++)
+		{
+			auto const& writer = m_Writers[index];
+			if (entity >= writer.first && entity < writer.last)
+			{
+				(writer.thread == thread ? owned : foreign) = true;
+			}
+		}
+		assert((owned || !foreign) && "Component written while another system holds its pool.");
+	}
+
+private:
+	struct Writer
+	{
+		std::thread::id thread;
+		Entity first;
+		Entity last;
+	};
+
+	std::mutex m_Mutex;
+
+	std::array<Writer, 64> m_Writers{};
+
+	size_t m_Count{};
+
+	// Lets Check skip the lock while nobody has a scope open
+	std::atomic<size_t> m_Active{};
+};
+#else
+class PoolWriteTracker
+{
+public:
+	void Begin(Entity, Entity)
+	{}
+
+	void End(Entity, Entity)
+	{}
+
+	void Check(Entity)
+	{}
+};
+#endif
+
+// Held by a system while it writes a pool, see Coordinator::WriteScope
+class PoolWriteScope
+{
+public:
+	PoolWriteScope(PoolWriteTracker& tracker, Entity first, Entity last)
+		: m_Tracker(tracker), m_First(first), m_Last(last)
+	{
+		m_Tracker.Begin(m_First, m_Last);
+	}
+
+	~PoolWriteScope()
+	{
+		m_Tracker.End(m_First, m_Last);
+	}
+
+	PoolWriteScope(const PoolWriteScope&) = delete;
+	PoolWriteScope& operator=(const PoolWriteScope&) = delete;
+
+private:
+	PoolWriteTracker& m_Tracker;
+
+	Entity m_First;
+
+	Entity m_Last;
 };
 
+// A component opts into double buffering by declaring
+// `static constexpr bool DOUBLE_BUFFERED = true;`. GetComponent then writes
+// the live copy in place while ReadComponent returns the copy committed when
+// the tick last advanced, so within a tick readers never see a write and the
+// order systems run in doesn't change what they read. Slots written during a
+// tick are copied into the committed array as it advances.
+template<typename T>
+constexpr bool IsDoubleBuffered()
+{
+	if constexpr (requires { T::DOUBLE_BUFFERED; })
+		return T::DOUBLE_BUFFERED;
+	else
+		return false;
+}
+
 class IComponentArray
 {
 public:
 	virtual ~IComponentArray() = default;
-	virtual void EntityDestroyed(Entity entity) = 0;
+	virtual void RemoveData(Entity entity) = 0;
+	virtual void SetTick(Tick tick) = 0;
+	virtual void FlushObservers() = 0;
+	virtual PoolStats GetStats() const = 0;
 };
 
 template<typename T>
 class ComponentArray : public IComponentArray
 {
 public:
-	void InsertData(Entity entity, T component)
+	ComponentArray()
 	{
-		assert(m_EntityToIndexMap.find(entity) == m_EntityToIndexMap.end() && "Component added to same entity more than once.");
+		m_EntityToIndex.fill(NONE);
+
+		// Two ticks of removals, so steady-state churn doesn't allocate
+		m_Removed.reserve(MAX_ENTITIES);
+	}
+
+	void InsertData(Entity entity, const T& component)
+	{
+		EmplaceData(entity, component);
+	}
+
+	void InsertData(Entity entity, T&& component)
+	{
+		EmplaceData(entity, std::move(component));
+	}
+
+	// Constructs the component straight into its slot
+	template<typename... Args>
+	T& EmplaceData(Entity entity, Args&&... args)
+	{
+		assert(entity < MAX_ENTITIES && "Entity out of range.");
+		assert(!HasData(entity) && "Component added to same entity more than once.");
 
 		size_t newIndex = m_Size;
-		m_EntityToIndexMap[entity] = newIndex;
-		m_IndexToEntityMap[newIndex] = entity;
-		m_ComponentArray[newIndex] = component;
+		m_EntityToIndex[entity] = (uint32_t)newIndex;
+		m_IndexToEntity[newIndex] = entity;
+
+		T* slot = &m_ComponentArray[newIndex];
+		std::destroy_at(slot);
+		std::construct_at(slot, std::forward<Args>(args)...);
+		if constexpr (BUFFERED)
+		{
+			// Readable straight away, there is no older state to show
+			m_Committed[newIndex] = *slot;
+		}
+		m_AddedTicks[newIndex] = m_Tick;
+		m_ChangedTicks[newIndex] = m_Tick;
 		++m_Size;
+
+		Notify(ComponentEvent::Add, entity);
+		Notify(ComponentEvent::Set, entity);
+
+		m_HighWater = std::max(m_HighWater, m_Size);
+		++m_Inserts;
+
+		return *slot;
 	}
 
-	void RemoveData(Entity entity)
+	void RemoveData(Entity entity) override
 	{
-		assert(m_EntityToIndexMap.find(entity) != m_EntityToIndexMap.end() && "Removing non-existent component.");
+		assert(HasData(entity) && "Removing non-existent component.");
 
-		size_t indexOfRemovedEntity = m_EntityToIndexMap[entity];
+		size_t indexOfRemovedEntity = m_EntityToIndex[entity];
 		size_t indexOfLastElement = m_Size - 1;
-		m_ComponentArray[indexOfRemovedEntity] = m_ComponentArray[indexOfLastElement];
+		if (indexOfRemovedEntity != indexOfLastElement)
+		{
+			m_ComponentArray[indexOfRemovedEntity] = std::move(m_ComponentArray[indexOfLastElement]);
+			if constexpr (BUFFERED)
+			{
+				m_Committed[indexOfRemovedEntity] = std::move(m_Committed[indexOfLastElement]);
+			}
+			m_AddedTicks[indexOfRemovedEntity] = m_AddedTicks[indexOfLastElement];
+			m_ChangedTicks[indexOfRemovedEntity] = m_ChangedTicks[indexOfLastElement];
+		}
+
+		Entity entityOfLastElement = m_IndexToEntity[indexOfLastElement];
+		m_EntityToIndex[entityOfLastElement] = (uint32_t)indexOfRemovedEntity;
+		m_IndexToEntity[indexOfRemovedEntity] = entityOfLastElement;
 
-		Entity entityOfLastElement = m_IndexToEntityMap[indexOfLastElement];
-		m_EntityToIndexMap[entityOfLastElement] = indexOfRemovedEntity;
-		m_IndexToEntityMap[indexOfRemovedEntity] = entityOfLastElement;
+		m_EntityToIndex[entity] = NONE;
 
-		m_EntityToIndexMap.erase(entity);
-		m_IndexToEntityMap.erase(indexOfLastElement);
+		m_Removed.push_back({ entity, m_Tick });
 
 		--m_Size;
+		++m_Removes;
+
+		Notify(ComponentEvent::Remove, entity);
+	}
+
+	// Replaces an existing component, as an OnSet observer sees it
+	template<typename U>
+	void SetData(Entity entity, U&& component)
+	{
+		GetData(entity) = std::forward<U>(component);
+
+		Notify(ComponentEvent::Set, entity);
+	}
+
+	bool HasData(Entity entity) const
+	{
+		return entity < MAX_ENTITIES && m_EntityToIndex[entity] != NONE;
 	}
 
+	// Mutable access, so the component counts as changed this tick. Only
+	// touches the entity's own slot, see PoolWriteTracker.
 	T& GetData(Entity entity)
 	{
-		assert(m_EntityToIndexMap.find(entity) != m_EntityToIndexMap.end() && "Retrieving non-existent component.");
+		assert(HasData(entity) && "Retrieving non-existent component.");
 
-		return m_ComponentArray[m_EntityToIndexMap[entity]];
+		m_Writes.Check(entity);
+
+		size_t index = m_EntityToIndex[entity];
+		m_ChangedTicks[index] = m_Tick;
+		return m_ComponentArray[index];
+	}
+
+	// The committed copy when T is double-buffered
+	const T& ReadData(Entity entity) const
+	{
+		assert(HasData(entity) && "Retrieving non-existent component.");
+
+		if constexpr (BUFFERED)
+			return m_Committed[m_EntityToIndex[entity]];
+		else
+			return m_ComponentArray[m_EntityToIndex[entity]];
+	}
+
+	PoolWriteTracker& GetWriteTracker()
+	{
+		return m_Writes;
+	}
+
+	void AddObserver(ComponentEvent event, ComponentObserver observer)
+	{
+		auto& observers = m_Observers[(size_t)event];
+		if (observers.callbacks.empty())
+		{
+			// Each entity is queued at most once, so this is all the space a batch needs
+			observers.pending.reserve(MAX_ENTITIES);
+			observers.flushing.reserve(MAX_ENTITIES);
+			observers.queued.resize(MAX_ENTITIES);
+		}
+		observers.callbacks.push_back(std::move(observer));
+	}
+
+	// Removals are reported before adds and sets, so an entity that lost and
+	// regained the component ends up present. Adds and sets are only reported
+	// for entities that still have the component.
+	void FlushObservers() override
+	{
+		for (size_t event = 0; event < (size_t)ComponentEvent::Count; event++)
+		{
+			auto& observers = m_Observers[event];
+			if (observers.pending.empty())
+				continue;
+
+			// Observers may add or remove components, those land in the next batch
+			observers.flushing.swap(observers.pending);
+			for (Entity entity : observers.flushing)
+			{
+				observers.queued[entity] = false;
+			}
+
+			if (event != (size_t)ComponentEvent::Remove)
+			{
+				std::erase_if(observers.flushing, [this](Entity entity) { return !HasData(entity); });
+			}
+
+			for (auto const& callback : observers.callbacks)
+			{
+				callback(observers.flushing);
+			}
+			observers.flushing.clear();
+		}
 	}
 
-	void EntityDestroyed(Entity entity) override
+	// The tick advancing is the sync point where double-buffered writes are committed
+	void SetTick(Tick tick) override
 	{
-		if (m_EntityToIndexMap.find(entity) != m_EntityToIndexMap.end())
+		if constexpr (BUFFERED)
 		{
-			RemoveData(entity);
+			Commit();
 		}
+
+		m_Tick = tick;
+
+		// Keep this tick's and the previous tick's removals
+		std::erase_if(m_Removed, [tick](RemovedEntry const& removed) { return removed.tick + 1 < tick; });
+	}
+
+	void GetChanged(Tick since, std::vector<Entity>& out) const
+	{
+		for (size_t index = 0; index < m_Size; index++)
+		{
+			if (m_ChangedTicks[index] > since)
+				out.push_back(m_IndexToEntity[index]);
+		}
+	}
+
+	void GetAdded(Tick since, std::vector<Entity>& out) const
+	{
+		for (size_t index = 0; index < m_Size; index++)
+		{
+			if (m_AddedTicks[index] > since)
+				out.push_back(m_IndexToEntity[index]);
+		}
+	}
+
+	// The entity may since have been destroyed, or been given a new T
+	void GetRemoved(Tick since, std::vector<Entity>& out) const
+	{
+		for (auto const& removed : m_Removed)
+		{
+			if (removed.tick > since)
+				out.push_back(removed.entity);
+		}
+	}
+
+	PoolStats GetStats() const override
+	{
+		return PoolStats{ .size = m_Size, .highWater = m_HighWater, .inserts = m_Inserts, .removes = m_Removes };
 	}
 
 private:
+	struct RemovedEntry
+	{
+		Entity entity;
+		Tick tick;
+	};
+
+	struct Observers
+	{
+		std::vector<ComponentObserver> callbacks;
+		std::vector<Entity> pending;
+		std::vector<Entity> flushing;
+		// Per entity, whether it is already in `pending`
+		std::vector<bool> queued;
+	};
+
+	std::array<Observers, (size_t)ComponentEvent::Count> m_Observers;
+
+	// Only slots handed out this tick can differ from their committed copy
+	void Commit()
+	{
+		for (size_t index = 0; index < m_Size; index++)
+		{
+			if (m_ChangedTicks[index] == m_Tick)
+				m_Committed[index] = m_ComponentArray[index];
+		}
+	}
+
+	// A single empty() test when nothing observes the event
+	void Notify(ComponentEvent event, Entity entity)
+	{
+		auto& observers = m_Observers[(size_t)event];
+		if (observers.callbacks.empty() || observers.queued[entity])
+			return;
+
+		observers.queued[entity] = true;
+		observers.pending.push_back(entity);
+	}
+
+	static constexpr uint32_t NONE = MAX_ENTITIES;
+
+	static constexpr bool BUFFERED = IsDoubleBuffered<T>();
+
+	struct NoBuffer
+	{};
+
 	std::array<T, MAX_ENTITIES> m_ComponentArray;
 
-	std::unordered_map<Entity, size_t> m_EntityToIndexMap;
+	// What ReadData returns for a double-buffered T, same layout as m_ComponentArray
+	[[no_unique_address]] std::conditional_t<BUFFERED, std::array<T, MAX_ENTITIES>, NoBuffer> m_Committed;
+
+	// Slot of each entity's component, NONE without one. Lookups never insert.
+	std::array<uint32_t, MAX_ENTITIES> m_EntityToIndex;
+
+	// Dense like the components, so change scans walk it in order
+	std::array<Entity, MAX_ENTITIES> m_IndexToEntity{};
+
+	// Tick each slot's component was last added and last handed out mutably
+	std::array<Tick, MAX_ENTITIES> m_AddedTicks{};
 
-	std::unordered_map<size_t, Entity> m_IndexToEntityMap;
+	std::array<Tick, MAX_ENTITIES> m_ChangedTicks{};
 
-	size_t m_Size;
+	std::vector<RemovedEntry> m_Removed;
+
+	Tick m_Tick = 1;
+
+	size_t m_Size{};
+
+	size_t m_HighWater{};
+
+	uint64_t m_Inserts{};
+
+	uint64_t m_Removes{};
+
+	PoolWriteTracker m_Writes;
 };
 
 class ComponentManager
 {
 public:
+	// `name` labels the pool in stats and soak reports. typeid names are
+	// mangled differently by each compiler, so reports couldn't be compared.
 	template<typename T>
-	void RegisterComponent()
+	void RegisterComponent(const char* name)
 	{
 		const char* typeName = typeid(T).name();
 
 		assert(m_ComponentTypes.find(typeName) == m_ComponentTypes.end() && "Registering component type more than once.");
+		assert(m_ComponentTypes.size() < MAX_COMPONENTS && "Too many component types, raise ECS_SIGNATURE_BITS.");
 
 		m_ComponentTypes.insert({ typeName, m_NextComponentType });
 
-		m_ComponentArrays.insert({ typeName, std::make_shared<ComponentArray<T>>() });
+		auto componentArray = std::make_shared<ComponentArray<T>>();
+		componentArray->SetTick(m_Tick);
+		m_ComponentArrays.insert({ typeName, componentArray });
+		m_ComponentArraysByType[m_NextComponentType] = componentArray.get();
+		m_ComponentNames[m_NextComponentType] = name;
 
 		++m_NextComponentType;
 	}
 
 	template<typename T>
-	ComponentType GetComponentType()
+	ComponentType GetComponentType() const
 	{
-
 		const char* typeName = typeid(T).name();
 
-		assert(m_ComponentTypes.find(typeName) != m_ComponentTypes.end() && "Component not registered before use.");
+		auto it = m_ComponentTypes.find(typeName);
 
-		return m_ComponentTypes[typeName];
+		assert(it != m_ComponentTypes.end() && "Component not registered before use.");
+
+		return it->second;
 	}
 
+	// Takes lvalues and rvalues, T may be deduced as a reference
 	template<typename T>
-	void AddComponent(Entity entity, T component)
+	void AddComponent(Entity entity, T&& component)
+	{
+		GetComponentArray<std::remove_cvref_t<T>>()->InsertData(entity, std::forward<T>(component));
+	}
+
+	template<typename T, typename... Args>
+	T& EmplaceComponent(Entity entity, Args&&... args)
 	{
-		GetComponentArray<T>()->InsertData(entity, component);
+		return GetComponentArray<T>()->EmplaceData(entity, std::forward<Args>(args)...);
 	}
 
 	template<typename T>
@@ -180,14 +884,116 @@ public:
 		return GetComponentArray<T>()->GetData(entity);
 	}
 
-	void EntityDestroyed(Entity entity)
+	template<typename T>
+	const T& ReadComponent(Entity entity) const
+	{
+		return GetComponentArray<T>()->ReadData(entity);
+	}
+
+	template<typename T>
+	bool HasComponent(Entity entity) const
+	{
+		return GetComponentArray<T>()->HasData(entity);
+	}
+
+	template<typename T>
+	PoolWriteTracker& GetWriteTracker()
+	{
+		return GetComponentArray<T>()->GetWriteTracker();
+	}
+
+	template<typename T>
+	void SetComponent(Entity entity, T&& component)
+	{
+		GetComponentArray<std::remove_cvref_t<T>>()->SetData(entity, std::forward<T>(component));
+	}
+
+	template<typename T>
+	void AddObserver(ComponentEvent event, ComponentObserver observer)
+	{
+		GetComponentArray<T>()->AddObserver(event, std::move(observer));
+	}
+
+	void FlushObservers()
+	{
+		for (size_t type = 0; type < m_ComponentTypes.size(); type++)
+		{
+			m_ComponentArraysByType[type]->FlushObservers();
+		}
+	}
+
+	template<typename T>
+	void Query(Changed<T>, Tick since, std::vector<Entity>& out) const
+	{
+		GetComponentArray<T>()->GetChanged(since, out);
+	}
+
+	template<typename T>
+	void Query(Added<T>, Tick since, std::vector<Entity>& out) const
+	{
+		GetComponentArray<T>()->GetAdded(since, out);
+	}
+
+	template<typename T>
+	void Query(Removed<T>, Tick since, std::vector<Entity>& out) const
+	{
+		GetComponentArray<T>()->GetRemoved(since, out);
+	}
+
+	Tick GetTick() const
+	{
+		return m_Tick;
+	}
+
+	void AdvanceTick()
 	{
+		++m_Tick;
 		for (auto const& pair : m_ComponentArrays)
 		{
-			auto const& component = pair.second;
+			pair.second->SetTick(m_Tick);
+		}
+	}
+
+	// Only visits the pools the signature says the entity has components in
+	void EntityDestroyed(Entity entity, const Signature& signature)
+	{
+		for (size_t type = 0; type < m_ComponentTypes.size(); type++)
+		{
+			if (signature.test(type))
+			{
+				m_ComponentArraysByType[type]->RemoveData(entity);
+			}
+		}
+	}
+
+	// Pool by pool, so each pool's data stays hot while all of its entities are removed
+	template<typename F>
+	void EntitiesDestroyed(std::span<const Entity> entities, F&& getSignature)
+	{
+		for (size_t type = 0; type < m_ComponentTypes.size(); type++)
+		{
+			IComponentArray* componentArray = m_ComponentArraysByType[type];
+			for (Entity entity : entities)
+			{
+				if (getSignature(entity).test(type))
+				{
+					componentArray->RemoveData(entity);
+				}
+			}
+		}
+	}
 
-			component->EntityDestroyed(entity);
+	void GetStats(EcsStats& stats) const
+	{
+		for (auto const& pair : m_ComponentArrays)
+		{
+			PoolStats pool = pair.second->GetStats();
+			pool.type = m_ComponentTypes.at(pair.first);
+			pool.name = m_ComponentNames[pool.type];
+			stats.pools.push_back(pool);
 		}
+
+		std::sort(stats.pools.begin(), stats.pools.end(), [](PoolStats const& a, PoolStats const& b) { return a.type < b.type; });
 	}
 
 private:
@@ -195,16 +1001,21 @@ private:
 
 	std::unordered_map<const char*, std::shared_ptr<IComponentArray>> m_ComponentArrays{};
 
+	// Owned by m_ComponentArrays, indexed by ComponentType for signature walks
+	std::array<IComponentArray*, MAX_COMPONENTS> m_ComponentArraysByType{};
+
+	std::array<const char*, MAX_COMPONENTS> m_ComponentNames{};
+
 	ComponentType m_NextComponentType{};
 
+	Tick m_Tick = 1;
+
+	// Only finds, so any number of threads may look pools up at once. A raw
+	// pointer, copying the shared_ptr would bounce its count between threads.
 	template<typename T>
-	std::shared_ptr<ComponentArray<T>> GetComponentArray()
+	ComponentArray<T>* GetComponentArray() const
 	{
-		const char* typeName = typeid(T).name();
-
-		assert(m_ComponentTypes.find(typeName) != m_ComponentTypes.end() && "Component not registered before use.");
-
-		return std::static_pointer_cast<ComponentArray<T>>(m_ComponentArrays[typeName]);
+		return static_cast<ComponentArray<T>*>(m_ComponentArraysByType[GetComponentType<T>()]);
 	}
 };
 
@@ -233,51 +1044,149 @@ public:
 
 		auto system = std::make_shared<T>();
 		m_Systems.insert({ typeName, system });
+		m_Stats.insert({ typeName, SystemStats{ typeName } });
 		return system;
 	}
 
 	template<typename T>
 	void SetSignature(Signature signature)
+	{
+		SetFilter<T>(SystemFilter{ .all = signature });
+	}
+
+	template<typename T>
+	void SetFilter(const SystemFilter& filter)
 	{
 		const char* typeName = typeid(T).name();
 
 		assert(m_Systems.find(typeName) != m_Systems.end() && "System used before registered.");
 
-		m_Signatures.insert({ typeName, signature });
+		// Assign rather than insert, re-signaturing a system must replace its filter
+		m_Filters[typeName] = filter;
 	}
 
-	void EntityDestroyed(Entity entity)
+	// Replaces the system's members with `entities`, which must be sorted
+	template<typename T>
+	void SetEntities(std::span<const Entity> entities)
+	{
+		const char* typeName = typeid(T).name();
+
+		assert(m_Systems.find(typeName) != m_Systems.end() && "System used before registered.");
+
+		auto& members = m_Systems[typeName]->m_Entities;
+		auto& stats = m_Stats[typeName];
+
+		size_t kept = 0;
+		for (Entity entity : entities)
+		{
+			kept += members.count(entity);
+		}
+		stats.added += entities.size() - kept;
+		stats.removed += members.size() - kept;
+
+		// Building from a sorted range is linear
+		members = std::set<Entity>(entities.begin(), entities.end());
+	}
+
+	// Only erases from systems the entity's signature matches, the others can't hold it
+	void EntityDestroyed(Entity entity, const Signature& entitySignature)
 	{
 		for (auto const& pair : m_Systems)
 		{
+			auto const& type = pair.first;
 			auto const& system = pair.second;
+			auto const& systemFilter = m_Filters[type];
 
-			system->m_Entities.erase(entity);
+			if (systemFilter.Matches(entitySignature))
+			{
+				if (system->m_Entities.erase(entity) > 0)
+				{
+					++m_Stats[type].removed;
+				}
+			}
+		}
+	}
+
+	template<typename F>
+	void EntitiesDestroyed(std::span<const Entity> entities, F&& getSignature)
+	{
+		for (auto const& pair : m_Systems)
+		{
+			auto const& type = pair.first;
+			auto const& system = pair.second;
+			auto const& systemFilter = m_Filters[type];
+			auto& stats = m_Stats[type];
+
+			for (Entity entity : entities)
+			{
+				if (systemFilter.Matches(getSignature(entity)))
+				{
+					if (system->m_Entities.erase(entity) > 0)
+					{
+						++stats.removed;
+					}
+				}
+			}
 		}
 	}
 
 	void EntitySignatureChanged(Entity entity, Signature entitySignature)
 	{
+		++m_SignatureChanges;
+
+		// An empty signature is the same as a free ID, it joins no system.
+		// EntityManager::Query skips them too, so back-fills agree with this.
+		bool hasComponents = entitySignature.any();
+
 		for (auto const& pair : m_Systems)
 		{
 			auto const& type = pair.first;
 			auto const& system = pair.second;
-			auto const& systemSignature = m_Signatures[type];
+			auto const& systemFilter = m_Filters[type];
 
-			if ((entitySignature & systemSignature) == systemSignature)
+			if (hasComponents && systemFilter.Matches(entitySignature))
 			{
-				system->m_Entities.insert(entity);
+				if (system->m_Entities.insert(entity).second)
+				{
+					++m_Stats[type].added;
+					++m_SystemsTouched;
+				}
 			}
 			else
 			{
-				system->m_Entities.erase(entity);
+				if (system->m_Entities.erase(entity) > 0)
+				{
+					++m_Stats[type].removed;
+					++m_SystemsTouched;
+				}
 			}
 		}
 	}
+
+	void GetStats(EcsStats& stats) const
+	{
+		stats.signatureChanges = m_SignatureChanges;
+		stats.systemsTouched = m_SystemsTouched;
+
+		for (auto const& pair : m_Systems)
+		{
+			SystemStats system = m_Stats.at(pair.first);
+			system.entities = pair.second->m_Entities.size();
+			stats.systems.push_back(system);
+		}
+
+		std::sort(stats.systems.begin(), stats.systems.end(), [](SystemStats const& a, SystemStats const& b) { return std::strcmp(a.name, b.name) < 0; });
+	}
 private:
-	std::unordered_map<const char*, Signature> m_Signatures{};
+	std::unordered_map<const char*, SystemFilter> m_Filters{};
 
 	std::unordered_map<const char*, std::shared_ptr<System>> m_Systems{};
+
+	std::unordered_map<const char*, SystemStats> m_Stats{};
+
+	uint64_t m_SignatureChanges{};
+
+	uint64_t m_SystemsTouched{};
 };
 
 class Coordinator
@@ -295,29 +1204,65 @@ public:
 		return m_EntityManager->CreateEntity();
 	}
 
+	// For worker threads, see EntityManager::ReserveEntity. Components are
+	// added later, usually through a CommandQueue spawn.
+	Entity ReserveEntity()
+	{
+		return m_EntityManager->ReserveEntity();
+	}
+
+	uint32_t GetLivingEntityCount() const
+	{
+		return m_EntityManager->GetLivingEntityCount();
+	}
+
 	void DestroyEntity(Entity entity)
 	{
+		// Read before EntityManager resets it
+		Signature signature = m_EntityManager->GetSignature(entity);
+
 		m_EntityManager->DestroyEntity(entity);
-		m_ComponentManager->EntityDestroyed(entity);
-		m_SystemManager->EntityDestroyed(entity);
+		m_ComponentManager->EntityDestroyed(entity, signature);
+		m_SystemManager->EntityDestroyed(entity, signature);
+	}
+
+	// Each entity must be alive and appear only once
+	void DestroyEntities(std::span<const Entity> entities)
+	{
+		auto getSignature = [this](Entity entity) { return m_EntityManager->GetSignature(entity); };
+
+		m_ComponentManager->EntitiesDestroyed(entities, getSignature);
+		m_SystemManager->EntitiesDestroyed(entities, getSignature);
+
+		for (Entity entity : entities)
+		{
+			m_EntityManager->DestroyEntity(entity);
+		}
 	}
 
 	template<typename T>
-	void RegisterComponent()
+	void RegisterComponent(const char* name)
 	{
-		m_ComponentManager->RegisterComponent<T>();
+		m_ComponentManager->RegisterComponent<T>(name);
 	}
 
 	template<typename T>
-	void AddComponent(Entity entity, T component)
+	void AddComponent(Entity entity, T&& component)
 	{
-		m_ComponentManager->AddComponent<T>(entity, component);
+		m_ComponentManager->AddComponent(entity, std::forward<T>(component));
 
-		auto signature = m_EntityManager->GetSignature(entity);
-		signature.set(m_ComponentManager->GetComponentType<T>(), true);
-		m_EntityManager->SetSignature(entity, signature);
+		ComponentAdded<std::remove_cvref_t<T>>(entity);
+	}
 
-		m_SystemManager->EntitySignatureChanged(entity, signature);
+	// Builds the component in its pool from `args`, nothing is copied
+	template<typename T, typename... Args>
+	T& EmplaceComponent(Entity entity, Args&&... args)
+	{
+		T& component = m_ComponentManager->EmplaceComponent<T>(entity, std::forward<Args>(args)...);
+
+		ComponentAdded<T>(entity);
+
+		return component;
 	}
 
 	template<typename T>
@@ -332,6 +1277,7 @@ public:
 		m_SystemManager->EntitySignatureChanged(entity, signature);
 	}
 
+	// Marks the component as changed, use ReadComponent where it is only read
 	template<typename T>
 	T& GetComponent(Entity entity)
 	{
@@ -339,65 +1285,190 @@ public:
 	}
 
 	template<typename T>
-	ComponentType GetComponentType()
+	const T& ReadComponent(Entity entity) const
+	{
+		return m_ComponentManager->ReadComponent<T>(entity);
+	}
+
+	template<typename T>
+	bool HasComponent(Entity entity) const
+	{
+		return m_ComponentManager->HasComponent<T>(entity);
+	}
+
+	// Declares that this thread writes T for entities [first, last) until the
+	// scope ends. Free in release, in debug it asserts on overlapping writers.
+	template<typename T>
+	[[nodiscard]] PoolWriteScope WriteScope(Entity first = 0, Entity last = MAX_ENTITIES)
+	{
+		return PoolWriteScope(m_ComponentManager->GetWriteTracker<T>(), first, last);
+	}
+
+	// Overwrites a component the entity already has and reports it to OnSet observers
+	template<typename T>
+	void SetComponent(Entity entity, T&& component)
+	{
+		m_ComponentManager->SetComponent(entity, std::forward<T>(component));
+	}
+
+	// Observers run in batches from FlushObservers, never from inside the
+	// call that added, removed or set the component
+	template<typename T>
+	void OnAdd(ComponentObserver observer)
+	{
+		m_ComponentManager->AddObserver<T>(ComponentEvent::Add, std::move(observer));
+	}
+
+	template<typename T>
+	void OnRemove(ComponentObserver observer)
+	{
+		m_ComponentManager->AddObserver<T>(ComponentEvent::Remove, std::move(observer));
+	}
+
+	// Fires on AddComponent, EmplaceComponent and SetComponent. Writes through
+	// GetComponent are only visible to Changed<T> queries.
+	template<typename T>
+	void OnSet(ComponentObserver observer)
+	{
+		m_ComponentManager->AddObserver<T>(ComponentEvent::Set, std::move(observer));
+	}
+
+	void FlushObservers()
+	{
+		m_ComponentManager->FlushObservers();
+	}
+
+	template<typename T>
+	ComponentType GetComponentType() const
 	{
 		return m_ComponentManager->GetComponentType<T>();
 	}
 
+	// Changes made now are stamped with this tick
+	Tick GetTick() const
+	{
+		return m_ComponentManager->GetTick();
+	}
+
+	// Called once per frame, after every system has run. Also commits every
+	// double-buffered component written this tick.
+	void AdvanceTick()
+	{
+		m_ComponentManager->AdvanceTick();
+	}
+
 	template<typename T>
 	std::shared_ptr<T> RegisterSystem()
 	{
-		return m_SystemManager->RegisterSystem<T>();
+		auto system = m_SystemManager->RegisterSystem<T>();
+
+		// No filter yet, which matches every entity with a component
+		BackFill<T>(SystemFilter{});
+
+		return system;
 	}
 
 	template<typename T>
 	void SetSystemSignature(Signature signature)
 	{
-		m_SystemManager->SetSignature<T>(signature);
+		SetSystemFilter<T>(SystemFilter{ .all = signature });
+	}
+
+	// Entities that already exist join or leave the system straight away
+	template<typename T>
+	void SetSystemFilter(const SystemFilter& filter)
+	{
+		m_SystemManager->SetFilter<T>(filter);
+
+		BackFill<T>(filter);
+	}
+
+	void Query(const SystemFilter& filter, std::vector<Entity>& out) const
+	{
+		m_EntityManager->Query(filter, out);
+	}
+
+	// Appends the entities matching a Changed<T>, Added<T> or Removed<T> filter
+	// since `since`, typically the tick the calling system last ran at
+	template<typename F>
+	void Query(Tick since, std::vector<Entity>& out) const
+	{
+		m_ComponentManager->Query(F{}, since, out);
+	}
+
+	// Snapshot of the counters kept by every manager, allocates so keep it off hot paths
+	EcsStats Stats() const
+	{
+		EcsStats stats;
+		m_EntityManager->GetStats(stats);
+		m_ComponentManager->GetStats(stats);
+		m_SystemManager->GetStats(stats);
+		return stats;
 	}
 
 private:
 	std::unique_ptr<ComponentManager> m_ComponentManager;
 	std::unique_ptr<EntityManager> m_EntityManager;
 	std::unique_ptr<SystemManager> m_SystemManager;
-};
-
 
-//Systems
-class PhysicsSystem : public System
-{
-public:
-	void Update(float deltaTime, olc::PixelGameEngine* pge);
-};
+	// Reused between back-fills so attaching systems doesn't allocate every time
+	std::vector<Entity> m_BackFillEntities;
 
-class RenderSystem : public System
-{
-public:
-	void Render(olc::PixelGameEngine* pge);
-};
+	// One scan over every signature instead of a membership update per entity
+	template<typename T>
+	void BackFill(const SystemFilter& filter)
+	{
+		m_BackFillEntities.clear();
+		m_EntityManager->Query(filter, m_BackFillEntities);
+		m_SystemManager->SetEntities<T>(m_BackFillEntities);
+	}
 
-class MovementSystem : public System
-{
-public:
-	void OnMove(olc::vf2d direction);
-};
+	template<typename T>
+	void ComponentAdded(Entity entity)
+	{
+		auto signature = m_EntityManager->GetSignature(entity);
+		signature.set(m_ComponentManager->GetComponentType<T>(), true);
+		m_EntityManager->SetSignature(entity, signature);
 
-class CollisionSystem : public System
-{
-public:
-	void CheckCollision(Entity other);
-	void CheckAllCollision();
+		m_SystemManager->EntitySignatureChanged(entity, signature);
+	}
 };
 
-class BulletSystem : public System
+// One JSON object per line, rates are per frame over the `frames` since `previous`
+inline void WriteStatsJson(std::ostream& out, const EcsStats& stats, const EcsStats& previous, uint64_t frame, uint64_t frames)
 {
-public:
-	void MoveBullet(float deltaTime, olc::PixelGameEngine* engine, std::shared_ptr<CollisionSystem> collisionSystem);
-};
+	double perFrame = 1.0 / (double)std::max<uint64_t>(frames, 1);
+
+	out << "{ \"frame\": " << frame
+		<< ", \"living_entities\": " << stats.livingEntities
+		<< ", \"free_entities\": " << stats.freeEntities
+		<< ", \"high_water_entities\": " << stats.highWaterEntities
+		<< ", \"max_entities\": " << MAX_ENTITIES
+		<< ", \"signature_changes_per_frame\": " << (stats.signatureChanges - previous.signatureChanges) * perFrame
+		<< ", \"systems_touched_per_frame\": " << (stats.systemsTouched - previous.systemsTouched) * perFrame
+		<< ", \"pools\": [";
+	for (size_t i = 0; i < stats.pools.size(); i++)
+	{
+		auto const& pool = stats.pools[i];
+		// Pools registered since the previous snapshot start from zero
+		PoolStats before = i < previous.pools.size() && previous.pools[i].name == pool.name ? previous.pools[i] : PoolStats{};
+		out << (i > 0 ? ", " : "") << "{ \"name\": \"" << pool.name << "\""
+			<< ", \"size\": " << pool.size
+			<< ", \"high_water\": " << pool.highWater
+			<< ", \"inserts_per_frame\": " << (pool.inserts - before.inserts) * perFrame
+			<< ", \"removes_per_frame\": " << (pool.removes - before.removes) * perFrame << " }";
+	}
+	out << "], \"systems\": [";
+	for (size_t i = 0; i < stats.systems.size(); i++)
+	{
+		auto const& system = stats.systems[i];
+		SystemStats before = i < previous.systems.size() && previous.systems[i].name == system.name ? previous.systems[i] : SystemStats{};
+		out << (i > 0 ? ", " : "") << "{ \"name\": \"" << system.name << "\""
+			<< ", \"entities\": " << system.entities
+			<< ", \"added_per_frame\": " << (system.added - before.added) * perFrame
+			<< ", \"removed_per_frame\": " << (system.removed - before.removed) * perFrame << " }";
+	}
+	out << "] }\n";
+}
 
-class AISystem : public System
-{
-public:
-	void Move(float deltaTime, olc::PixelGameEngine* engine, std::shared_ptr<CollisionSystem> collisionSystem);
-	void Shoot(float deltaTime);
-};
\ No newline at end of file
+extern Coordinator g_Coordinator;
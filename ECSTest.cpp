@@ -0,0 +1,100 @@
+/*
+	Consistency checks for the ECS core that the demo can't exercise on its own.
+
+	g++ -o ECSTest ECSTest.cpp Systems.cpp AllocTracker.cpp -O2 -DOLC_PLATFORM_HEADLESS -DOLC_GFX_NULL -lpthread -lpng -std=c++20
+
+	./ECSTest
+*/
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+#include "ECS.h"
+#include <array>
+#include <iostream>
+
+static bool Check(const std::string& name, bool passed)
+{
+	std::cout << (passed ? "ok   " : "FAIL ") << name << std::endl;
+	return passed;
+}
+
+template<size_t I, bool LATE>
+class MembershipSystem : public System
+{};
+
+// The filters whose edge cases differ most: nothing required, only an
+// exclusion, and a plain requirement
+template<bool LATE>
+std::array<std::shared_ptr<System>, 3> AttachMembershipSystems(Coordinator& coordinator)
+{
+	SystemFilter noneOnly;
+	noneOnly.none.set(coordinator.GetComponentType<Bullet>());
+	SystemFilter requiresTransform;
+	requiresTransform.all.set(coordinator.GetComponentType<Transform>());
+
+	std::array<std::shared_ptr<System>, 3> systems;
+	systems[0] = coordinator.RegisterSystem<MembershipSystem<0, LATE>>();
+	systems[1] = coordinator.RegisterSystem<MembershipSystem<1, LATE>>();
+	coordinator.SetSystemFilter<MembershipSystem<1, LATE>>(noneOnly);
+	systems[2] = coordinator.RegisterSystem<MembershipSystem<2, LATE>>();
+	coordinator.SetSystemFilter<MembershipSystem<2, LATE>>(requiresTransform);
+	return systems;
+}
+
+// A system attached after the entities exist must end up with the same
+// members as one that saw every change as it happened
+static bool CheckLateRegistration()
+{
+	auto coordinator = std::make_unique<Coordinator>();
+	coordinator->Init();
+	coordinator->RegisterComponent<Transform>("Transform");
+	coordinator->RegisterComponent<Collision>("Collision");
+	coordinator->RegisterComponent<Bullet>("Bullet");
+
+	auto early = AttachMembershipSystems<false>(*coordinator);
+
+	std::vector<Entity> entities;
+	for (uint32_t i = 0; i < 64; i++)
+	{
+		Entity entity = coordinator->CreateEntity();
+		if (i % 2 == 0)
+			coordinator->AddComponent(entity, Transform{});
+		if (i % 3 == 0)
+			coordinator->AddComponent(entity, Collision{});
+		if (i % 5 == 0)
+			coordinator->AddComponent(entity, Bullet{});
+		entities.push_back(entity);
+	}
+
+	// Some entities lose every component, others only some, without being destroyed
+	for (uint32_t i = 0; i < 64; i += 4)
+	{
+		Entity entity = entities[i];
+		coordinator->RemoveComponent<Transform>(entity);
+		if (coordinator->HasComponent<Collision>(entity))
+			coordinator->RemoveComponent<Collision>(entity);
+		if (coordinator->HasComponent<Bullet>(entity) && i % 8 == 0)
+			coordinator->RemoveComponent<Bullet>(entity);
+	}
+	for (uint32_t i = 1; i < 64; i += 7)
+	{
+		coordinator->DestroyEntity(entities[i]);
+	}
+
+	auto late = AttachMembershipSystems<true>(*coordinator);
+
+	const char* names[] = { "no filter", "none-only filter", "all filter" };
+	bool ok = true;
+	for (size_t i = 0; i < early.size(); i++)
+	{
+		ok &= Check(std::string("late registration matches early, ") + names[i], early[i]->m_Entities == late[i]->m_Entities);
+	}
+	return ok;
+}
+
+int main()
+{
+	bool ok = CheckLateRegistration();
+
+	std::cout << (ok ? "all passed" : "failures") << std::endl;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+#include "ECS.h"
+#include "TypeList.h"
+
+// Fixed-capacity buffer of one event type. Any number of threads may Push at
+// once, a slot is claimed with a single fetch_add. Reading and Clear must wait
+// until every producer for the frame has finished.
+template<typename E, size_t CAPACITY>
+class EventQueue
+{
+public:
+	// Returns false, and counts the event as dropped, once the queue is full
+	bool Push(const E& event)
+	{
+		size_t index = m_Count.fetch_add(1, std::memory_order_relaxed);
+		if (index >= CAPACITY)
+		{
+			m_Dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		m_Events[index] = event;
+		return true;
+	}
+
+	std::span<const E> Events() const
+	{
+		return { m_Events.data(), Size() };
+	}
+
+	size_t Size() const
+	{
+		return std::min(m_Count.load(std::memory_order_relaxed), CAPACITY);
+	}
+
+	void Clear()
+	{
+		m_Count.store(0, std::memory_order_relaxed);
+	}
+
+	uint64_t GetDropped() const
+	{
+		return m_Dropped.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::array<E, CAPACITY> m_Events{};
+
+	std::atomic<size_t> m_Count{};
+
+	std::atomic<uint64_t> m_Dropped{};
+};
+
+// Events default to one per entity per frame, declare a static CAPACITY to change it
+template<typename E>
+constexpr size_t EventCapacity()
+{
+	if constexpr (requires { E::CAPACITY; })
+		return E::CAPACITY;
+	else
+		return MAX_ENTITIES;
+}
+
+// One queue per event type, picked at compile time. Producers Emit during the
+// frame, consumers read Get<E>() in bulk afterwards, and Clear() empties
+// every queue at the end of the frame.
+template<typename... Es>
+class EventBus
+{
+public:
+	template<typename E>
+	bool Emit(const E& event)
+	{
+		return GetQueue<E>().Push(event);
+	}
+
+	template<typename E>
+	std::span<const E> Get() const
+	{
+		return GetQueue<E>().Events();
+	}
+
+	template<typename E>
+	uint64_t GetDropped() const
+	{
+		return GetQueue<E>().GetDropped();
+	}
+
+	void Clear()
+	{
+		(GetQueue<Es>().Clear(), ...);
+	}
+
+private:
+	std::tuple<EventQueue<Es, EventCapacity<Es>()>...> m_Queues;
+
+	template<typename E>
+	EventQueue<E, EventCapacity<E>()>& GetQueue()
+	{
+		constexpr size_t index = TypeIndex<E, Es...>();
+		static_assert(index < sizeof...(Es), "Event is not part of this bus.");
+		return std::get<index>(m_Queues);
+	}
+
+	template<typename E>
+	const EventQueue<E, EventCapacity<E>()>& GetQueue() const
+	{
+		return const_cast<EventBus*>(this)->GetQueue<E>();
+	}
+};
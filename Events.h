@@ -0,0 +1,22 @@
+#pragma once
+#include "EventBus.h"
+#include "Resources.h"
+
+// `entity` overlapped `other` when it was checked this frame
+struct HitEvent
+{
+	Entity entity;
+	Entity other;
+};
+
+// A new bullet to spawn at the end of the frame
+struct ShotFiredEvent
+{
+	olc::vf2d position;
+	olc::vf2d velocity;
+	ResourceHandle decal;
+};
+
+using GameEvents = EventBus<HitEvent, ShotFiredEvent>;
+
+extern GameEvents g_Events;
@@ -1,232 +1,135 @@
 #define OLC_PGE_APPLICATION
 #include "olcPixelGameEngine.h"
 #include "ECS.h"
-
-Coordinator g_Coordinator;
-
-void PhysicsSystem::Update(float deltaTime, olc::PixelGameEngine* engine)
+#include "AllocTracker.h"
+#include "CommandQueue.h"
+#include "Events.h"
+#include "Profiler.h"
+#include "Replay.h"
+#include "Resources.h"
+#include "Soak.h"
+#include "SpatialGrid.h"
+#include "Systems.h"
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+
+// Stress runs step the simulation at a fixed rate so every run does the same work
+const float STRESS_TIME_STEP = 1.0f / 60.0f;
+// Wider than an enemy and a bullet's combined radii, neighbouring columns never touch
+const float STRESS_COLUMN_SPACING = 14.0f;
+
+struct StressScenario
 {
-	for (auto const& entity : m_Entities)
-	{
-		auto& rigidBody = g_Coordinator.GetComponent<RigidBody>(entity);
-		auto& transform = g_Coordinator.GetComponent<Transform>(entity);
-		auto const& gravity = g_Coordinator.GetComponent<Gravity>(entity);
-
-		transform.position += rigidBody.velocity * deltaTime;
-
-		rigidBody.velocity += gravity.force * deltaTime;
-
-		if (transform.position.y <= -5.0f)
-		{
-			g_Coordinator.DestroyEntity(entity);
-		}
-	}
-}
-
-void RenderSystem::Render(olc::PixelGameEngine* engine)
-{
-	engine->Clear(olc::BLANK);
-	for (auto const& entity : m_Entities)
-	{
-		auto& transform = g_Coordinator.GetComponent<Transform>(entity);
-		auto& graphic = g_Coordinator.GetComponent<Graphic>(entity);
-		auto& collision = g_Coordinator.GetComponent<Collision>(entity);
-
-		graphic.tint = collision.isCollision ? olc::DARK_RED : olc::WHITE;
-		engine->DrawDecal(transform.position, graphic.decal.get(), transform.scale, graphic.tint);
-
-		//Draw collision circle
-		//engine->DrawCircle(transform.position + collision.center, collision.radius, collision.isCollision ? olc::GREEN : olc::WHITE);
-	}
-}
+	bool enabled = false;
+	// Enemies kept alive, replacements spawn as they are shot down
+	uint32_t enemies = 1000;
+	float fireInterval = 0.5f;
+	float bulletSpeed = 100.0f;
+	uint64_t frames = 300;
+	// Enemies spawned per frame while ramping up
+	uint32_t rampRate = 100;
+};
 
-void MovementSystem::OnMove(olc::vf2d direction)
+class SpaceShooter : public olc::PixelGameEngine
 {
-	for (auto const& entity : m_Entities)
+public:
+	SpaceShooter()
 	{
-		auto& transfrom = g_Coordinator.GetComponent<Transform>(entity);
-		auto& input = g_Coordinator.GetComponent<Input>(entity);
-
-		transfrom.position += direction * input.speed;
+		sAppName = "SpaceShooter";
 	}
-}
-
-void CollisionSystem::CheckCollision(Entity entity)
-{
-	auto& transform1 = g_Coordinator.GetComponent<Transform>(entity);
-	auto& collision1 = g_Coordinator.GetComponent<Collision>(entity);
 
-	for (auto const& other : m_Entities)
-	{
-		if (entity == other)
-			continue;
-
-		auto& transform2 = g_Coordinator.GetComponent<Transform>(other);
-		auto& collision2 = g_Coordinator.GetComponent<Collision>(other);
-
-		olc::vf2d pos1 = transform1.position;
-		olc::vf2d pos2 = transform2.position;
-		float radii = collision1.radius + collision2.radius;
-
-		collision1.isCollision = ((pos1.x - pos2.x) * (pos1.x - pos2.x) +
-								 (pos1.y - pos2.y) * (pos1.y - pos2.y)) <= radii * radii;
-
-		collision2.isCollision = collision1.isCollision;
+	std::shared_ptr<PhysicsSystem> physicsSystem;
+	std::shared_ptr<RenderSystem> renderSystem;
+	std::shared_ptr<MovementSystem> movementSystem;
+	std::shared_ptr<CollisionSystem> collisionSystem;
+	std::shared_ptr<BulletSystem> bulletSystem;
+	std::shared_ptr<AISystem> aiSystem;
 
-		if (collision1.isCollision)
-		{
-			break;
-		}
-	}
-}
+	ResourceHandle shipDecal{};
+	ResourceHandle bulletDecal{};
+	ResourceHandle enemyDecal{};
+	ResourceHandle enemyBulletDecal{};
 
-void CollisionSystem::CheckAllCollision()
-{
-	for (auto const& entity1 : m_Entities)
-	{
-		for (auto const& entity2 : m_Entities)
-		{
-			if (entity1 == entity2)
-				continue;
+	float spawnInterval = 5.0f;
+	float spawnTimer = spawnInterval;
 
-			auto& transform1 = g_Coordinator.GetComponent<Transform>(entity1);
-			auto& collision1 = g_Coordinator.GetComponent<Collision>(entity1);
+	// All randomness in the simulation comes from here so a seed reproduces a run
+	uint32_t seed = std::random_device{}();
+	std::mt19937 rng;
 
-			auto& transform2 = g_Coordinator.GetComponent<Transform>(entity2);
-			auto& collision2 = g_Coordinator.GetComponent<Collision>(entity2);
+	std::unique_ptr<InputRecorder> recorder;
+	std::unique_ptr<InputReplayer> replayer;
 
-			olc::vf2d pos1 = transform1.position;
-			olc::vf2d pos2 = transform2.position;
-			float radii = collision1.radius + collision2.radius;
+	bool showProfiler = false;
+	bool perfCounters = false;
+	bool allocStats = false;
+	bool frameTimeStats = false;
+	std::string tracePath;
 
-			collision2.isCollision = ((pos1.x - pos2.x) * (pos1.x - pos2.x) +
-									  (pos1.y - pos2.y) * (pos1.y - pos2.y)) <= radii * radii;
+	std::ofstream statsFile;
+	uint32_t statsInterval = 60;
+	uint64_t frame = 0;
+	EcsStats lastStats;
 
-			collision1.isCollision = collision2.isCollision;
+	StressScenario stress;
+	std::vector<float> stressFrameTimes;
+	uint32_t stressPeakEntities = 0;
+	uint64_t stressDroppedSpawns = 0;
+	uint32_t stressNextColumn = 0;
 
-			if (collision1.isCollision)
-			{
-				return;
-			}
-		}
-	}
-}
+	// Soak runs hand the ship to a bot and watch for resources that keep growing
+	std::unique_ptr<SoakMonitor> soak;
+	uint64_t soakFrames = 0;
+	uint32_t soakSampleInterval = 600;
+	bool soakPassed = true;
 
-void BulletSystem::MoveBullet(float deltaTime, olc::PixelGameEngine* engine, std::shared_ptr<CollisionSystem> collisionSystem)
-{
-	for (auto const& entity : m_Entities)
+public:
+	bool OnUserCreate() override
 	{
-		auto& transform = g_Coordinator.GetComponent<Transform>(entity);
-		auto& bullet = g_Coordinator.GetComponent<Bullet>(entity);
-		auto& collision = g_Coordinator.GetComponent<Collision>(entity);
-
-
-		transform.position += bullet.velocity * deltaTime;
-		collisionSystem->CheckCollision(entity);
+		// Called once at the start, so create things here
 
-		//Destroy bullet if collide or outside of game window
-		if (collision.isCollision || transform.position.y < -collision.radius || transform.position.y > engine->ScreenHeight() + collision.radius)
+		if (replayer)
 		{
-			g_Coordinator.DestroyEntity(entity);
+			seed = replayer->GetSeed();
 		}
-	}
-}
+		rng.seed(seed);
 
-void AISystem::Move(float deltaTime, olc::PixelGameEngine* engine, std::shared_ptr<CollisionSystem> collisionSystem)
-{
-	for (auto const& entity : m_Entities)
-	{
-		auto& transform = g_Coordinator.GetComponent<Transform>(entity);
-		auto& ai = g_Coordinator.GetComponent<AI>(entity);
-		auto& collision = g_Coordinator.GetComponent<Collision>(entity);
-
-
-		transform.position += ai.velocity * deltaTime;
-		collisionSystem->CheckCollision(entity);
-
-		if (transform.position.y > engine->ScreenHeight() + collision.radius)
+		if (stress.enabled)
 		{
-			transform.position.y = -collision.radius * 2.0f;
+			stressFrameTimes.reserve(stress.frames);
 		}
 
-		//Destroy enemy if collide
-		if (collision.isCollision)
+		SetCorePhaseHook([](const char* phase, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
 		{
-			g_Coordinator.DestroyEntity(entity);
-		}
-	}
-}
+			g_Profiler.Record(phase, g_Profiler.ToNanoseconds(start), g_Profiler.ToNanoseconds(end));
+		});
 
-void AISystem::Shoot(float deltaTime)
-{
-	for (auto const& entity : m_Entities)
-	{
-		auto& ai = g_Coordinator.GetComponent<AI>(entity);
-
-		ai.shootTimer += deltaTime;
-
-		if (ai.shootTimer >= ai.shootInterval)
+		// Counters follow the thread that opens them, which has to be the engine thread
+		if (perfCounters)
 		{
-			auto& transform = g_Coordinator.GetComponent<Transform>(entity);
-			auto& collision = g_Coordinator.GetComponent<Collision>(entity);
-
-			olc::vf2d scale = olc::vf2d(0.1f, 0.1f);
-			std::shared_ptr<olc::Decal> decal = std::make_shared<olc::Decal>(new olc::Sprite("BulletEnemy.png"));
-
-			Entity entity = g_Coordinator.CreateEntity();
-			g_Coordinator.AddComponent(entity, Transform{ .position = transform.position + olc::vf2d(5.0f, 10.0f), .scale = scale });
-			g_Coordinator.AddComponent(entity, Graphic{ .decal = decal, .tint = olc::WHITE });
-			g_Coordinator.AddComponent(entity, Bullet{ .velocity = olc::vf2d(0.0f, 100.0f) });
-			g_Coordinator.AddComponent(entity, Collision{ .radius = 2.0f,
-														  .center = olc::vf2d(decal.get()->sprite->width * 0.5f,
-																			  decal.get()->sprite->height * 0.5f) * scale });
-
-			ai.shootTimer -= ai.shootInterval;
+			g_PerfCounters.Enable();
 		}
-	}
-}
-
-class SpaceShooter : public olc::PixelGameEngine
-{
-public:
-	SpaceShooter()
-	{
-		sAppName = "SpaceShooter";
-	}
-
-	std::shared_ptr<PhysicsSystem> physicsSystem;
-	std::shared_ptr<RenderSystem> renderSystem;
-	std::shared_ptr<MovementSystem> movementSystem;
-	std::shared_ptr<CollisionSystem> collisionSystem;
-	std::shared_ptr<BulletSystem> bulletSystem;
-	std::shared_ptr<AISystem> aiSystem;
 
-	olc::Sprite* shipSprite = nullptr;
-	olc::Sprite* bulletSprite = nullptr;
-	olc::Sprite* enemySprite = nullptr;
-
-	float spawnInterval = 5.0f;
-	float spawnTimer = spawnInterval;
-
-public:
-	bool OnUserCreate() override
-	{
-		// Called once at the start, so create things here
+		// One decal per entity at most, reserving up front keeps Render allocation-free
+		GetLayers()[0].vecDecalInstance.reserve(MAX_ENTITIES);
 
-		shipSprite = new olc::Sprite("Ship.png");
-		bulletSprite = new olc::Sprite("Bullet.png");
-		enemySprite = new olc::Sprite("Enemy.png");
+		shipDecal = g_Resources.LoadDecal("Ship.png");
+		bulletDecal = g_Resources.LoadDecal("Bullet.png");
+		enemyDecal = g_Resources.LoadDecal("Enemy.png");
+		enemyBulletDecal = g_Resources.LoadDecal("BulletEnemy.png");
 
 		g_Coordinator.Init();
 
-		g_Coordinator.RegisterComponent<Gravity>();
-		g_Coordinator.RegisterComponent<RigidBody>();
-		g_Coordinator.RegisterComponent<Transform>();
-		g_Coordinator.RegisterComponent<Graphic>();
-		g_Coordinator.RegisterComponent<Input>();
-		g_Coordinator.RegisterComponent<Collision>();
-		g_Coordinator.RegisterComponent<Bullet>();
-		g_Coordinator.RegisterComponent<AI>();
+		g_Coordinator.RegisterComponent<Gravity>("Gravity");
+		g_Coordinator.RegisterComponent<RigidBody>("RigidBody");
+		g_Coordinator.RegisterComponent<Transform>("Transform");
+		g_Coordinator.RegisterComponent<Graphic>("Graphic");
+		g_Coordinator.RegisterComponent<Input>("Input");
+		g_Coordinator.RegisterComponent<Collision>("Collision");
+		g_Coordinator.RegisterComponent<Bullet>("Bullet");
+		g_Coordinator.RegisterComponent<AI>("AI");
 
 		physicsSystem = g_Coordinator.RegisterSystem<PhysicsSystem>();
 		renderSystem = g_Coordinator.RegisterSystem<RenderSystem>();
@@ -270,19 +173,21 @@ public:
 		signature.set(g_Coordinator.GetComponentType<AI>());
 		g_Coordinator.SetSystemSignature<AISystem>(signature);
 
+		TrackSpatialIndex(g_Coordinator, collisionSystem->m_Grid);
+
 		std::vector<Entity> entities(MAX_ENTITIES);
 
 		olc::vf2d scale = olc::vf2d(0.1f, 0.1f);
-		std::shared_ptr<olc::Decal> decal = std::make_shared<olc::Decal>(shipSprite);
+		olc::Sprite* sprite = g_Resources.GetSprite(shipDecal);
 
 		// Create player entity
 		Entity entity = g_Coordinator.CreateEntity();
-		g_Coordinator.AddComponent(entity, Transform{ .position = olc::vf2d(ScreenWidth() * 0.5f, ScreenHeight() * 0.8f -(decal.get()->sprite->height * scale.y)), .scale = scale });
-		g_Coordinator.AddComponent(entity, Graphic{ .decal = decal, .tint = olc::WHITE });
+		g_Coordinator.AddComponent(entity, Transform{ .position = olc::vf2d(ScreenWidth() * 0.5f, ScreenHeight() * 0.8f -(sprite->height * scale.y)), .scale = scale });
+		g_Coordinator.AddComponent(entity, Graphic{ .decal = shipDecal, .tint = olc::WHITE });
 		g_Coordinator.AddComponent(entity, Input{ .speed = 100.0f });
 		g_Coordinator.AddComponent(entity, Collision{ .radius = 6.0f,
-													  .center = olc::vf2d(decal.get()->sprite->width * 0.5f,
-																		  decal.get()->sprite->height * 0.5f) * scale });
+													  .center = olc::vf2d(sprite->width * 0.5f,
+																		  sprite->height * 0.5f) * scale });
 
 		return true;
 	}
@@ -290,56 +195,218 @@ public:
 	bool OnUserUpdate(float fElapsedTime) override
 	{
 		// called once per frame
-		renderSystem->Render(this);
+		g_Profiler.BeginFrame();
 
-		//physicsSystem->Update(fElapsedTime, this);
-		if (GetKey(olc::Key::UP).bHeld)
+		FrameInput input;
+		if (replayer)
 		{
-			movementSystem->OnMove(olc::vf2d(0.0f, -1.0f) * fElapsedTime);
+			if (!replayer->Read(input))
+				return false;
 		}
-		else if (GetKey(olc::Key::DOWN).bHeld)
+		else
 		{
-			movementSystem->OnMove(olc::vf2d(0.0f, 1.0f) * fElapsedTime);
+			input = soak ? BotInput(frame) : PollInput(stress.enabled ? STRESS_TIME_STEP : fElapsedTime);
+			if (recorder)
+			{
+				recorder->Write(input);
+			}
 		}
 
-		if (GetKey(olc::Key::RIGHT).bHeld)
+		Simulate(input);
+
+		if (stress.enabled)
 		{
-			movementSystem->OnMove(olc::vf2d(1.0f, 0.0f) * fElapsedTime);
+			// The first frame is timed from the end of OnUserCreate, not from a previous frame
+			if (frame > 0)
+			{
+				stressFrameTimes.push_back(fElapsedTime);
+			}
+			stressPeakEntities = std::max(stressPeakEntities, g_Coordinator.GetLivingEntityCount());
 		}
-		else if (GetKey(olc::Key::LEFT).bHeld)
+
+		frame++;
+		if (statsFile.is_open() && frame % statsInterval == 0)
 		{
-			movementSystem->OnMove(olc::vf2d(-1.0f, 0.0f) * fElapsedTime);
+			EcsStats stats = g_Coordinator.Stats();
+			WriteStatsJson(statsFile, stats, lastStats, frame, statsInterval);
+			lastStats = std::move(stats);
+		}
+		if (soak && frame % soakSampleInterval == 0)
+		{
+			soak->Sample(frame * STRESS_TIME_STEP, GetTextureCount(), g_Coordinator.Stats());
 		}
 
-		if (GetKey(olc::Key::SPACE).bPressed)
+		if (GetKey(olc::Key::F1).bPressed)
 		{
-			CreateBullet(collisionSystem->GetEntity(0));
+			showProfiler = !showProfiler;
+		}
+		if (GetKey(olc::Key::F2).bPressed)
+		{
+			g_Profiler.ExportChromeTrace("trace.json");
+		}
+		if (showProfiler)
+		{
+			g_Profiler.DrawOverlay(this, 2, 2);
 		}
 
-		bulletSystem->MoveBullet(fElapsedTime, this, collisionSystem);
+		g_Coordinator.FlushObservers();
+		g_Coordinator.AdvanceTick();
+		g_PerfCounters.EndFrame();
+		g_AllocTracker.EndFrame();
 
-		SpawnEnemy(fElapsedTime);
-		aiSystem->Move(fElapsedTime, this, collisionSystem);
-		aiSystem->Shoot(fElapsedTime);
+		return (!stress.enabled || frame < stress.frames) && (!soak || frame < soakFrames);
+	}
 
+	bool OnUserDestroy() override
+	{
+		// Decals have to go while the renderer is still around
+		g_Resources.Clear();
+
+		if (!tracePath.empty())
+		{
+			g_Profiler.ExportChromeTrace(tracePath);
+		}
+		if (g_PerfCounters.IsEnabled())
+		{
+			g_PerfCounters.WriteZonesJson(std::cout);
+			std::cout << std::endl;
+		}
+		if (stress.enabled)
+		{
+			PrintStressReport();
+		}
+		if (soak)
+		{
+			soakPassed = soak->Report(std::cout);
+			std::cout << std::endl;
+		}
+		if (allocStats)
+		{
+			g_AllocTracker.WriteZonesJson(std::cout);
+			std::cout << std::endl;
+		}
+		if (frameTimeStats)
+		{
+			PrintFrameTimes();
+		}
 		return true;
 	}
 
-	void CreateBullet(Entity owner)
+	FrameInput PollInput(float fElapsedTime)
 	{
-		auto& transform = g_Coordinator.GetComponent<Transform>(owner);
-		auto& collision = g_Coordinator.GetComponent<Collision>(owner);
+		FrameInput input;
+		input.elapsedTime = fElapsedTime;
+		if (GetKey(olc::Key::UP).bHeld) input.keys |= FrameInput::UP_HELD;
+		if (GetKey(olc::Key::DOWN).bHeld) input.keys |= FrameInput::DOWN_HELD;
+		if (GetKey(olc::Key::LEFT).bHeld) input.keys |= FrameInput::LEFT_HELD;
+		if (GetKey(olc::Key::RIGHT).bHeld) input.keys |= FrameInput::RIGHT_HELD;
+		if (GetKey(olc::Key::SPACE).bPressed) input.keys |= FrameInput::FIRE_PRESSED;
+		return input;
+	}
 
-		olc::vf2d scale = olc::vf2d(0.1f, 0.1f);
-		std::shared_ptr<olc::Decal> decal = std::make_shared<olc::Decal>(bulletSprite);
+	// Sweeps the ship across the screen, drifts it up and down and fires steadily.
+	// Steps at the same fixed rate as stress runs so soak length is in game time.
+	FrameInput BotInput(uint64_t botFrame)
+	{
+		FrameInput input;
+		input.elapsedTime = STRESS_TIME_STEP;
+		input.keys |= (botFrame / 120) % 2 == 0 ? FrameInput::RIGHT_HELD : FrameInput::LEFT_HELD;
+		if ((botFrame / 300) % 4 == 1) input.keys |= FrameInput::UP_HELD;
+		if ((botFrame / 300) % 4 == 3) input.keys |= FrameInput::DOWN_HELD;
+		if (botFrame % 15 == 0) input.keys |= FrameInput::FIRE_PRESSED;
+		return input;
+	}
 
-		Entity entity = g_Coordinator.CreateEntity();
-		g_Coordinator.AddComponent(entity, Transform{ .position = transform.position + olc::vf2d(5.0f, -10.0f), .scale = scale });
-		g_Coordinator.AddComponent(entity, Graphic{ .decal = decal, .tint = olc::WHITE });
-		g_Coordinator.AddComponent(entity, Bullet{ .velocity = olc::vf2d(0.0f, -150.0f) });
-		g_Coordinator.AddComponent(entity, Collision{ .radius = 2.0f,
-													  .center = olc::vf2d(decal.get()->sprite->width * 0.5f,
-																		  decal.get()->sprite->height * 0.5f) * scale });
+	void Simulate(const FrameInput& input)
+	{
+		float fElapsedTime = input.elapsedTime;
+
+		{
+			PROFILE_SCOPE("Render");
+			ALLOC_FREE_SCOPE("Render");
+			renderSystem->Render(this);
+		}
+
+		//physicsSystem->Update(fElapsedTime, this);
+		{
+			PROFILE_SCOPE("OnMove");
+			ALLOC_FREE_SCOPE("OnMove");
+			if (input.Has(FrameInput::UP_HELD))
+			{
+				movementSystem->OnMove(olc::vf2d(0.0f, -1.0f) * fElapsedTime);
+			}
+			else if (input.Has(FrameInput::DOWN_HELD))
+			{
+				movementSystem->OnMove(olc::vf2d(0.0f, 1.0f) * fElapsedTime);
+			}
+
+			if (input.Has(FrameInput::RIGHT_HELD))
+			{
+				movementSystem->OnMove(olc::vf2d(1.0f, 0.0f) * fElapsedTime);
+			}
+			else if (input.Has(FrameInput::LEFT_HELD))
+			{
+				movementSystem->OnMove(olc::vf2d(-1.0f, 0.0f) * fElapsedTime);
+			}
+		}
+
+		if (input.Has(FrameInput::FIRE_PRESSED))
+		{
+			ALLOC_SCOPE("CreateBullet");
+			CreateBullet(collisionSystem->GetEntity(0));
+		}
+
+		{
+			PROFILE_SCOPE("MoveBullet");
+			ALLOC_SCOPE("MoveBullet");
+			bulletSystem->MoveBullet(fElapsedTime, this);
+		}
+		{
+			PROFILE_SCOPE("SpawnEnemy");
+			ALLOC_SCOPE("SpawnEnemy");
+			if (stress.enabled)
+			{
+				SpawnStressEnemies();
+			}
+			else
+			{
+				SpawnEnemy(fElapsedTime);
+			}
+		}
+		{
+			PROFILE_SCOPE("Move");
+			ALLOC_SCOPE("Move");
+			aiSystem->Move(fElapsedTime, this);
+		}
+		{
+			PROFILE_SCOPE("Collision");
+			ALLOC_SCOPE("Collision");
+			collisionSystem->Update();
+			bulletSystem->ResolveHits();
+			aiSystem->ResolveHits();
+		}
+		{
+			PROFILE_SCOPE("Shoot");
+			ALLOC_SCOPE("Shoot");
+			aiSystem->Shoot(fElapsedTime);
+			bulletSystem->SpawnBullets();
+		}
+		{
+			PROFILE_SCOPE("ApplyCommands");
+			ALLOC_SCOPE("ApplyCommands");
+			g_Commands.Apply(g_Coordinator);
+		}
+
+		g_Events.Clear();
+	}
+
+	void CreateBullet(Entity owner)
+	{
+		auto const& transform = g_Coordinator.ReadComponent<Transform>(owner);
+
+		g_Events.Emit(ShotFiredEvent{ .position = transform.position + olc::vf2d(5.0f, -10.0f),
+									  .velocity = olc::vf2d(0.0f, -150.0f),
+									  .decal = bulletDecal });
 	}
 
 	void SpawnEnemy(float deltaTime)
@@ -348,25 +415,28 @@ public:
 		if (spawnTimer >= spawnInterval)
 		{
 			olc::vf2d scale = olc::vf2d(0.1f, 0.1f);
-			std::shared_ptr<olc::Decal> enemyDecal = std::make_shared<olc::Decal>(enemySprite);
+			olc::Sprite* sprite = g_Resources.GetSprite(enemyDecal);
 
-			int enemyCount = rand() % 10;
+			int enemyCount = rng() % 10;
 			if (enemyCount < 1)
 			{
 				enemyCount = 1;
 			}
-			for (size_t i = 0; i < enemyCount; i++)
+			for (size_t i = 0; i < enemyCount && g_Coordinator.GetLivingEntityCount() < MAX_ENTITIES; i++)
 			{
 				Entity entity = g_Coordinator.CreateEntity();
 
-				olc::vf2d randomPosition = olc::vf2d(rand() % (ScreenWidth() - (enemyDecal.get()->sprite->width)), -(rand() % (int)(ScreenHeight() - (enemyDecal.get()->sprite->width) * 0.5f)));
+				// Drawn one at a time, argument evaluation order would make replays compiler dependent
+				int randomX = rng() % (ScreenWidth() - (sprite->width));
+				int randomY = rng() % (int)(ScreenHeight() - (sprite->width) * 0.5f);
+				olc::vf2d randomPosition = olc::vf2d(randomX, -randomY);
 
 				g_Coordinator.AddComponent(entity, Transform{ .position = randomPosition, .scale = scale });
 				g_Coordinator.AddComponent(entity, Graphic{ .decal = enemyDecal, .tint = olc::WHITE });
-				g_Coordinator.AddComponent(entity, AI{ .velocity = olc::vf2d(0.0f, 50.0f), .shootInterval = 2.0f });
+				g_Coordinator.AddComponent(entity, AI{ .velocity = olc::vf2d(0.0f, 50.0f), .shootInterval = 2.0f, .bulletSpeed = 100.0f, .bulletDecal = enemyBulletDecal });
 				g_Coordinator.AddComponent(entity, Collision{ .radius = 6.0f,
-															  .center = olc::vf2d(enemyDecal.get()->sprite->width * 0.5f,
-																				  enemyDecal.get()->sprite->height * 0.5f) * scale });
+															  .center = olc::vf2d(sprite->width * 0.5f,
+																				  sprite->height * 0.5f) * scale });
 			}
 
 			
@@ -375,13 +445,234 @@ public:
 		}
 	}
 
+	// Tops the enemy count back up to the scenario's, a few per frame so the world ramps up.
+	// Enemies get a column each, the field runs off the right of the screen so thousands
+	// of them and their bullets fit without colliding with each other.
+	void SpawnStressEnemies()
+	{
+		olc::vf2d scale = olc::vf2d(0.1f, 0.1f);
+		olc::Sprite* sprite = g_Resources.GetSprite(enemyDecal);
+		olc::vf2d center = olc::vf2d(sprite->width * 0.5f, sprite->height * 0.5f) * scale;
+
+		size_t missing = stress.enemies - std::min<size_t>(aiSystem->m_Entities.size(), stress.enemies);
+		for (size_t i = 0; i < std::min<size_t>(missing, stress.rampRate); i++)
+		{
+			if (g_Coordinator.GetLivingEntityCount() == MAX_ENTITIES)
+			{
+				stressDroppedSpawns += std::min<size_t>(missing, stress.rampRate) - i;
+				break;
+			}
+
+			Entity entity = g_Coordinator.CreateEntity();
+
+			float x = (stressNextColumn++ % stress.enemies) * STRESS_COLUMN_SPACING;
+			int randomY = rng() % (ScreenHeight() / 4);
+			// Spread the first shots out so the enemies don't all fire on the same frame
+			float shootTimer = (rng() % 1000) * 0.001f * stress.fireInterval;
+
+			g_Coordinator.AddComponent(entity, Transform{ .position = olc::vf2d(x, randomY), .scale = scale });
+			g_Coordinator.AddComponent(entity, Graphic{ .decal = enemyDecal, .tint = olc::WHITE });
+			g_Coordinator.AddComponent(entity, AI{ .velocity = olc::vf2d(0.0f, 50.0f), .shootInterval = stress.fireInterval, .bulletSpeed = stress.bulletSpeed, .shootTimer = shootTimer, .bulletDecal = enemyBulletDecal });
+			g_Coordinator.AddComponent(entity, Collision{ .radius = 6.0f, .center = center });
+		}
+	}
+
+	void PrintStressReport()
+	{
+		std::vector<float> times = stressFrameTimes;
+		std::sort(times.begin(), times.end());
+
+		auto percentile = [&](double p)
+		{
+			if (times.empty())
+				return 0.0;
+			return times[std::min(times.size() - 1, (size_t)(p * times.size()))] * 1000.0;
+		};
+
+		std::cout << "{ \"enemies\": " << stress.enemies
+			<< ", \"fire_interval\": " << stress.fireInterval
+			<< ", \"bullet_speed\": " << stress.bulletSpeed
+			<< ", \"frames\": " << stress.frames
+			<< ", \"frame_ms\": { \"p50\": " << percentile(0.50)
+			<< ", \"p95\": " << percentile(0.95)
+			<< ", \"p99\": " << percentile(0.99)
+			<< ", \"max\": " << (times.empty() ? 0.0 : times.back() * 1000.0) << " }"
+			<< ", \"max_entities\": " << MAX_ENTITIES
+			<< ", \"peak_entities\": " << stressPeakEntities
+			<< ", \"final_entities\": " << g_Coordinator.GetLivingEntityCount()
+			<< ", \"dropped_spawns\": " << stressDroppedSpawns
+			<< ", \"dropped_shots\": " << bulletSystem->m_DroppedShots.load() << " }" << std::endl;
+	}
+
+	// The engine's frame time histogram, with only the buckets that were hit
+	void PrintFrameTimes()
+	{
+		auto const& histogram = GetFrameTimeHistogram();
+		auto const& buckets = histogram.GetBuckets();
+
+		std::cout << "{ \"target_fps\": " << GetTargetFrameRate()
+			<< ", \"frames\": " << histogram.GetCount()
+			<< ", \"frame_ms\": { \"mean\": " << histogram.GetMean() * 1000.0f
+			<< ", \"p50\": " << histogram.GetPercentile(0.50f) * 1000.0f
+			<< ", \"p95\": " << histogram.GetPercentile(0.95f) * 1000.0f
+			<< ", \"p99\": " << histogram.GetPercentile(0.99f) * 1000.0f
+			<< ", \"max\": " << histogram.GetMax() * 1000.0f << " }"
+			<< ", \"bucket_ms\": " << olc::FrameTimeHistogram::fBucketWidth * 1000.0f
+			<< ", \"buckets\": {";
+		bool first = true;
+		for (size_t i = 0; i < buckets.size(); i++)
+		{
+			if (buckets[i] == 0)
+				continue;
+			std::cout << (first ? " " : ", ") << "\"" << i << "\": " << buckets[i];
+			first = false;
+		}
+		std::cout << " } }" << std::endl;
+	}
+
 };
 
-int main()
+#if defined(OLC_PLATFORM_HEADLESS)
+// Stands in for the player when there is no keyboard, sweeps the ship
+// from side to side and keeps tapping fire
+void ScriptedInput(olc::PixelGameEngine* engine, uint64_t frame)
+{
+	bool movingRight = (frame / 120) % 2 == 0;
+	engine->olc_UpdateKeyState(olc::Key::RIGHT, movingRight);
+	engine->olc_UpdateKeyState(olc::Key::LEFT, !movingRight);
+	engine->olc_UpdateKeyState(olc::Key::SPACE, frame % 15 == 0);
+}
+#endif
+
+int main(int argc, char* argv[])
 {
 	SpaceShooter demo;
+	std::string recordPath;
+	std::string replayPath;
+	double soakTolerance = 0.1;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--seed" && i + 1 < argc)
+		{
+			demo.seed = (uint32_t)std::stoul(argv[++i]);
+		}
+		else if (arg == "--record" && i + 1 < argc)
+		{
+			recordPath = argv[++i];
+		}
+		else if (arg == "--replay" && i + 1 < argc)
+		{
+			replayPath = argv[++i];
+		}
+		else if (arg == "--profile")
+		{
+			demo.showProfiler = true;
+		}
+		else if (arg == "--perf")
+		{
+			demo.perfCounters = true;
+		}
+		else if (arg == "--allocs")
+		{
+			demo.allocStats = true;
+		}
+		else if (arg == "--alloc-check")
+		{
+			g_AllocTracker.SetChecking(true);
+		}
+		else if (arg == "--stats" && i + 1 < argc)
+		{
+			demo.statsFile.open(argv[++i]);
+		}
+		else if (arg == "--stats-interval" && i + 1 < argc)
+		{
+			demo.statsInterval = std::max(1, std::stoi(argv[++i]));
+		}
+		else if (arg == "--stress")
+		{
+			demo.stress.enabled = true;
+		}
+		else if (arg == "--enemies" && i + 1 < argc)
+		{
+			demo.stress.enemies = (uint32_t)std::stoul(argv[++i]);
+		}
+		else if (arg == "--fire-interval" && i + 1 < argc)
+		{
+			demo.stress.fireInterval = std::stof(argv[++i]);
+		}
+		else if (arg == "--bullet-speed" && i + 1 < argc)
+		{
+			demo.stress.bulletSpeed = std::stof(argv[++i]);
+		}
+		else if (arg == "--ramp" && i + 1 < argc)
+		{
+			demo.stress.rampRate = (uint32_t)std::stoul(argv[++i]);
+		}
+		else if (arg == "--stress-frames" && i + 1 < argc)
+		{
+			demo.stress.frames = std::stoull(argv[++i]);
+		}
+		else if (arg == "--soak" && i + 1 < argc)
+		{
+			// Minutes of game time
+			demo.soakFrames = (uint64_t)(std::stod(argv[++i]) * 60.0 / STRESS_TIME_STEP);
+		}
+		else if (arg == "--soak-tolerance" && i + 1 < argc)
+		{
+			soakTolerance = std::stod(argv[++i]);
+		}
+		else if (arg == "--trace" && i + 1 < argc)
+		{
+			demo.tracePath = argv[++i];
+		}
+#if defined(OLC_PLATFORM_HEADLESS)
+		else if (arg == "--frames" && i + 1 < argc)
+		{
+			olc::Platform_Headless::nMaxFrames = std::stoull(argv[++i]);
+		}
+#endif
+		else if (arg == "--fps" && i + 1 < argc)
+		{
+			demo.SetTargetFrameRate(std::stof(argv[++i]));
+		}
+		else if (arg == "--frame-times")
+		{
+			demo.frameTimeStats = true;
+		}
+	}
+
+	if (!replayPath.empty())
+	{
+		demo.replayer = std::make_unique<InputReplayer>();
+		if (!demo.replayer->Open(replayPath))
+		{
+			std::cerr << "Could not open replay " << replayPath << std::endl;
+			return 1;
+		}
+	}
+	else if (!recordPath.empty())
+	{
+		demo.recorder = std::make_unique<InputRecorder>();
+		if (!demo.recorder->Open(recordPath, demo.seed))
+		{
+			std::cerr << "Could not open " << recordPath << " for recording" << std::endl;
+			return 1;
+		}
+	}
+
+	if (demo.soakFrames > 0)
+	{
+		demo.soak = std::make_unique<SoakMonitor>(soakTolerance);
+	}
+
+#if defined(OLC_PLATFORM_HEADLESS)
+	olc::Platform_Headless::funcInput = ScriptedInput;
+#endif
+
 	if (demo.Construct(256, 240, 4, 4))
 		demo.Start();
 
-	return 0;
-}
\ No newline at end of file
+	return demo.soakPassed ? 0 : 1;
+}
@@ -0,0 +1,202 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+enum PerfCounter
+{
+	PERF_CYCLES,
+	PERF_INSTRUCTIONS,
+	PERF_L1D_MISSES,
+	PERF_LLC_MISSES,
+	PERF_BRANCH_MISSES,
+	PERF_COUNTER_COUNT,
+};
+
+const char* const PERF_COUNTER_NAMES[PERF_COUNTER_COUNT] = { "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses" };
+
+// A counter the kernel refused to open reads as -1
+using PerfCounterValues = std::array<int64_t, PERF_COUNTER_COUNT>;
+
+const size_t PERF_MAX_ZONES = 32;
+
+struct PerfZone
+{
+	const char* name = nullptr;
+	uint64_t calls{};
+	int64_t nanoseconds{};
+	PerfCounterValues counters{};
+};
+
+// Hardware counters through perf_event_open, accumulated per named zone.
+// Counters only see the thread that called Enable(), and every counter
+// degrades to -1 on its own when the kernel, CPU or sandbox refuses it.
+class PerfCounters
+{
+public:
+	~PerfCounters()
+	{
+		Disable();
+	}
+
+	void Enable()
+	{
+		if (m_Enabled)
+			return;
+
+#if defined(__linux__)
+		auto open = [](uint32_t type, uint64_t config)
+		{
+			perf_event_attr attr{};
+			attr.type = type;
+			attr.size = sizeof(attr);
+			attr.config = config;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+		};
+
+		m_Fds[PERF_CYCLES] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+		m_Fds[PERF_INSTRUCTIONS] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+		m_Fds[PERF_L1D_MISSES] = open(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+		m_Fds[PERF_LLC_MISSES] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+		m_Fds[PERF_BRANCH_MISSES] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+
+		m_Enabled = true;
+	}
+
+	void Disable()
+	{
+#if defined(__linux__)
+		for (auto& fd : m_Fds)
+		{
+			if (fd != -1)
+				close(fd);
+			fd = -1;
+		}
+#endif
+		m_Enabled = false;
+	}
+
+	bool IsEnabled() const
+	{
+		return m_Enabled;
+	}
+
+	bool IsAvailable(PerfCounter counter) const
+	{
+		return m_Fds[counter] != -1;
+	}
+
+	// Running totals since Enable(), subtract two reads to get a delta
+	PerfCounterValues Read() const
+	{
+		PerfCounterValues values;
+		values.fill(-1);
+#if defined(__linux__)
+		for (size_t counter = 0; counter < PERF_COUNTER_COUNT; counter++)
+		{
+			int64_t value = 0;
+			if (m_Fds[counter] != -1 && read(m_Fds[counter], &value, sizeof(value)) == sizeof(value))
+				values[counter] = value;
+		}
+#endif
+		return values;
+	}
+
+	void Accumulate(const char* name, int64_t nanoseconds, const PerfCounterValues& start, const PerfCounterValues& end)
+	{
+		size_t zone = 0;
+		while (zone < m_ZoneCount && m_Zones[zone].name != name)
+			zone++;
+		if (zone == m_ZoneCount)
+		{
+			if (m_ZoneCount == PERF_MAX_ZONES)
+				return;
+			m_Zones[m_ZoneCount++] = PerfZone{ name };
+		}
+
+		auto& perfZone = m_Zones[zone];
+		perfZone.calls++;
+		perfZone.nanoseconds += nanoseconds;
+		for (size_t counter = 0; counter < PERF_COUNTER_COUNT; counter++)
+		{
+			if (start[counter] < 0 || end[counter] < 0)
+				perfZone.counters[counter] = -1;
+			else if (perfZone.counters[counter] >= 0)
+				perfZone.counters[counter] += end[counter] - start[counter];
+		}
+	}
+
+	void EndFrame()
+	{
+		m_Frames++;
+	}
+
+	uint64_t GetFrames() const
+	{
+		return m_Frames;
+	}
+
+	size_t GetZoneCount() const
+	{
+		return m_ZoneCount;
+	}
+
+	const PerfZone& GetZone(size_t index) const
+	{
+		return m_Zones[index];
+	}
+
+	void ResetZones()
+	{
+		m_ZoneCount = 0;
+		m_Frames = 0;
+	}
+
+	// One JSON object per zone with per-frame averages, unavailable counters are null
+	void WriteZonesJson(std::ostream& out) const
+	{
+		double frames = (double)std::max<uint64_t>(m_Frames, 1);
+		out << "[";
+		for (size_t zone = 0; zone < m_ZoneCount; zone++)
+		{
+			auto const& perfZone = m_Zones[zone];
+			out << (zone > 0 ? ", " : "") << "{ \"name\": \"" << perfZone.name << "\""
+				<< ", \"calls_per_frame\": " << perfZone.calls / frames
+				<< ", \"ns_per_frame\": " << perfZone.nanoseconds / frames;
+			for (size_t counter = 0; counter < PERF_COUNTER_COUNT; counter++)
+			{
+				out << ", \"" << PERF_COUNTER_NAMES[counter] << "_per_frame\": ";
+				if (perfZone.counters[counter] < 0)
+					out << "null";
+				else
+					out << perfZone.counters[counter] / frames;
+			}
+			out << " }";
+		}
+		out << "]";
+	}
+
+private:
+	bool m_Enabled = false;
+
+	std::array<int, PERF_COUNTER_COUNT> m_Fds{ -1, -1, -1, -1, -1 };
+
+	std::array<PerfZone, PERF_MAX_ZONES> m_Zones{};
+
+	size_t m_ZoneCount{};
+
+	uint64_t m_Frames{};
+};
+
+extern PerfCounters g_PerfCounters;
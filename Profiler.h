@@ -0,0 +1,239 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "olcPixelGameEngine.h"
+#include "PerfCounters.h"
+
+const size_t PROFILER_CAPACITY = 1 << 16;
+const size_t PROFILER_MAX_ZONES = 32;
+
+struct ProfileEvent
+{
+	// Must point at a string literal, events outlive the scope that recorded them
+	const char* name = nullptr;
+	int64_t start{};
+	int64_t end{};
+	uint32_t frame{};
+	uint32_t thread{};
+};
+
+struct ProfileZoneStats
+{
+	const char* name = nullptr;
+	double averageMs{};
+	double maxMs{};
+};
+
+// Fixed size ring buffer of timed scopes, oldest events are overwritten
+// once PROFILER_CAPACITY is reached. Recording never allocates or locks.
+class Profiler
+{
+public:
+	Profiler()
+		: m_Epoch(std::chrono::steady_clock::now())
+	{}
+
+	void BeginFrame()
+	{
+		m_Frame.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	uint32_t GetFrame() const
+	{
+		return m_Frame.load(std::memory_order_relaxed);
+	}
+
+	int64_t Now() const
+	{
+		return ToNanoseconds(std::chrono::steady_clock::now());
+	}
+
+	int64_t ToNanoseconds(std::chrono::steady_clock::time_point tp) const
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(tp - m_Epoch).count();
+	}
+
+	void Record(const char* name, int64_t start, int64_t end)
+	{
+		uint64_t index = m_Next.fetch_add(1, std::memory_order_relaxed);
+		auto& event = m_Events[index % PROFILER_CAPACITY];
+		event.name = name;
+		event.start = start;
+		event.end = end;
+		event.frame = GetFrame();
+		event.thread = ThreadIndex();
+	}
+
+	// Average and worst time per zone over the last `frames` completed frames,
+	// fills `stats` and returns how many zones were found
+	size_t GetZoneStats(uint32_t frames, std::array<ProfileZoneStats, PROFILER_MAX_ZONES>& stats) const
+	{
+		uint32_t currentFrame = GetFrame();
+		if (currentFrame == 0 || frames == 0)
+			return 0;
+
+		uint32_t firstFrame = currentFrame > frames ? currentFrame - frames : 0;
+
+		// Zone time is summed per frame so a zone entered twice in a frame counts once.
+		// Events are visited newest first, which groups them by frame.
+		std::array<double, PROFILER_MAX_ZONES> frameSum{};
+		std::array<uint32_t, PROFILER_MAX_ZONES> sumFrame{};
+		size_t zoneCount = 0;
+
+		auto flush = [&](size_t zone)
+		{
+			stats[zone].averageMs += frameSum[zone];
+			stats[zone].maxMs = std::max(stats[zone].maxMs, frameSum[zone]);
+			frameSum[zone] = 0.0;
+		};
+
+		uint64_t next = m_Next.load(std::memory_order_relaxed);
+		uint64_t oldest = next > PROFILER_CAPACITY ? next - PROFILER_CAPACITY : 0;
+		for (uint64_t index = next; index-- > oldest;)
+		{
+			auto const& event = m_Events[index % PROFILER_CAPACITY];
+			if (event.frame < firstFrame)
+				break;
+			if (event.frame >= currentFrame)
+				continue;
+
+			size_t zone = 0;
+			while (zone < zoneCount && stats[zone].name != event.name)
+				zone++;
+			if (zone == zoneCount)
+			{
+				if (zoneCount == PROFILER_MAX_ZONES)
+					continue;
+				stats[zoneCount++] = ProfileZoneStats{ event.name };
+				sumFrame[zone] = event.frame;
+			}
+			else if (sumFrame[zone] != event.frame)
+			{
+				flush(zone);
+				sumFrame[zone] = event.frame;
+			}
+			frameSum[zone] += (event.end - event.start) * 1e-6;
+		}
+
+		uint32_t frameCount = currentFrame - firstFrame;
+		for (size_t zone = 0; zone < zoneCount; zone++)
+		{
+			flush(zone);
+			stats[zone].averageMs /= frameCount;
+		}
+
+		// Oldest first so zones keep a stable order on screen
+		std::reverse(stats.begin(), stats.begin() + zoneCount);
+		return zoneCount;
+	}
+
+	void DrawOverlay(olc::PixelGameEngine* engine, int32_t x, int32_t y, uint32_t frames = 60) const
+	{
+		std::array<ProfileZoneStats, PROFILER_MAX_ZONES> stats;
+		size_t zoneCount = GetZoneStats(frames, stats);
+
+		char line[64];
+		std::snprintf(line, sizeof(line), "%-12s %6s %6s", "ms", "avg", "max");
+		engine->DrawString(x, y, line, olc::YELLOW);
+
+		for (size_t zone = 0; zone < zoneCount; zone++)
+		{
+			y += 10;
+			std::snprintf(line, sizeof(line), "%-12.12s %6.2f %6.2f", stats[zone].name, stats[zone].averageMs, stats[zone].maxMs);
+			engine->DrawString(x, y, line, olc::YELLOW);
+		}
+	}
+
+	// Writes every buffered event from frames [firstFrame, lastFrame] in the
+	// Chrome trace_event format, open it in chrome://tracing or Perfetto
+	bool ExportChromeTrace(const std::string& path, uint32_t firstFrame = 0, uint32_t lastFrame = UINT32_MAX) const
+	{
+		std::ofstream file(path);
+		if (!file.is_open())
+			return false;
+
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+		bool first = true;
+		uint64_t next = m_Next.load(std::memory_order_relaxed);
+		uint64_t oldest = next > PROFILER_CAPACITY ? next - PROFILER_CAPACITY : 0;
+		for (uint64_t index = oldest; index < next; index++)
+		{
+			auto const& event = m_Events[index % PROFILER_CAPACITY];
+			if (event.frame < firstFrame || event.frame > lastFrame)
+				continue;
+
+			file << (first ? "" : ",\n")
+				<< "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1"
+				<< ",\"tid\":" << event.thread
+				<< ",\"ts\":" << event.start / 1000.0
+				<< ",\"dur\":" << (event.end - event.start) / 1000.0
+				<< ",\"args\":{\"frame\":" << event.frame << "}}";
+			first = false;
+		}
+
+		file << "\n]}\n";
+		return file.good();
+	}
+
+private:
+	std::array<ProfileEvent, PROFILER_CAPACITY> m_Events{};
+
+	std::atomic<uint64_t> m_Next{};
+
+	std::atomic<uint32_t> m_Frame{};
+
+	std::chrono::steady_clock::time_point m_Epoch;
+
+	static uint32_t ThreadIndex()
+	{
+		static std::atomic<uint32_t> s_NextThread{};
+		thread_local uint32_t t_Thread = s_NextThread.fetch_add(1, std::memory_order_relaxed);
+		return t_Thread;
+	}
+};
+
+extern Profiler g_Profiler;
+
+// Times the enclosing scope, and samples hardware counters for it when
+// g_PerfCounters has been enabled
+class ProfileScope
+{
+public:
+	explicit ProfileScope(const char* name)
+		: m_Name(name)
+	{
+		if (g_PerfCounters.IsEnabled())
+			m_Counters = g_PerfCounters.Read();
+		m_Start = g_Profiler.Now();
+	}
+
+	~ProfileScope()
+	{
+		int64_t end = g_Profiler.Now();
+		g_Profiler.Record(m_Name, m_Start, end);
+		if (g_PerfCounters.IsEnabled())
+			g_PerfCounters.Accumulate(m_Name, end - m_Start, m_Counters, g_PerfCounters.Read());
+	}
+
+private:
+	const char* m_Name;
+	int64_t m_Start;
+	PerfCounterValues m_Counters;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if defined(ECS_NO_PROFILER)
+	#define PROFILE_SCOPE(name)
+#else
+	#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#endif
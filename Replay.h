@@ -0,0 +1,93 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+// Everything the simulation reads from outside the world in one frame
+struct FrameInput
+{
+	enum Keys : uint8_t
+	{
+		UP_HELD = 1 << 0,
+		DOWN_HELD = 1 << 1,
+		LEFT_HELD = 1 << 2,
+		RIGHT_HELD = 1 << 3,
+		FIRE_PRESSED = 1 << 4,
+	};
+
+	float elapsedTime = 0.0f;
+	uint8_t keys = 0;
+
+	bool Has(Keys key) const { return (keys & key) != 0; }
+};
+
+// Replay files are a small header followed by 5 bytes per frame:
+//   "ECSR" | uint32 version | uint32 rng seed | { float elapsedTime, uint8 keys }...
+const char REPLAY_MAGIC[4] = { 'E', 'C', 'S', 'R' };
+const uint32_t REPLAY_VERSION = 1;
+
+class InputRecorder
+{
+public:
+	bool Open(const std::string& path, uint32_t seed)
+	{
+		m_File.open(path, std::ios::binary | std::ios::trunc);
+		if (!m_File.is_open())
+			return false;
+
+		m_File.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+		m_File.write(reinterpret_cast<const char*>(&REPLAY_VERSION), sizeof(REPLAY_VERSION));
+		m_File.write(reinterpret_cast<const char*>(&seed), sizeof(seed));
+		return m_File.good();
+	}
+
+	void Write(const FrameInput& input)
+	{
+		m_File.write(reinterpret_cast<const char*>(&input.elapsedTime), sizeof(input.elapsedTime));
+		m_File.write(reinterpret_cast<const char*>(&input.keys), sizeof(input.keys));
+	}
+
+private:
+	std::ofstream m_File;
+};
+
+class InputReplayer
+{
+public:
+	bool Open(const std::string& path)
+	{
+		m_File.open(path, std::ios::binary);
+		if (!m_File.is_open())
+			return false;
+
+		char magic[4]{};
+		uint32_t version = 0;
+		m_File.read(magic, sizeof(magic));
+		m_File.read(reinterpret_cast<char*>(&version), sizeof(version));
+		m_File.read(reinterpret_cast<char*>(&m_Seed), sizeof(m_Seed));
+
+		return m_File.good()
+			&& std::equal(std::begin(magic), std::end(magic), std::begin(REPLAY_MAGIC))
+			&& version == REPLAY_VERSION;
+	}
+
+	uint32_t GetSeed() const
+	{
+		return m_Seed;
+	}
+
+	// Returns false once the recording has run out
+	bool Read(FrameInput& input)
+	{
+		m_File.read(reinterpret_cast<char*>(&input.elapsedTime), sizeof(input.elapsedTime));
+		m_File.read(reinterpret_cast<char*>(&input.keys), sizeof(input.keys));
+		return m_File.good();
+	}
+
+private:
+	std::ifstream m_File;
+
+	uint32_t m_Seed{};
+};
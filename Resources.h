@@ -0,0 +1,74 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "olcPixelGameEngine.h"
+
+// Index into the ResourceTable, small and trivially copyable so components can hold one
+using ResourceHandle = std::uint32_t;
+
+// Owns every sprite and the decal uploaded from it. Handles stay valid until
+// Clear(), which must run while the renderer is still alive.
+class ResourceTable
+{
+public:
+	// Each file is loaded once, loading the same path again returns the same handle
+	ResourceHandle LoadDecal(const std::string& path)
+	{
+		auto it = m_Paths.find(path);
+		if (it != m_Paths.end())
+			return it->second;
+
+		ResourceHandle handle = AddDecal(std::make_unique<olc::Sprite>(path));
+		m_Paths.insert({ path, handle });
+		return handle;
+	}
+
+	ResourceHandle AddDecal(std::unique_ptr<olc::Sprite> sprite)
+	{
+		ResourceHandle handle = (ResourceHandle)m_Decals.size();
+		m_Decals.push_back(std::make_unique<olc::Decal>(sprite.get()));
+		m_Sprites.push_back(std::move(sprite));
+		return handle;
+	}
+
+	olc::Decal* GetDecal(ResourceHandle handle) const
+	{
+		assert(handle < m_Decals.size() && "Resource handle out of range.");
+
+		return m_Decals[handle].get();
+	}
+
+	olc::Sprite* GetSprite(ResourceHandle handle) const
+	{
+		assert(handle < m_Sprites.size() && "Resource handle out of range.");
+
+		return m_Sprites[handle].get();
+	}
+
+	size_t GetCount() const
+	{
+		return m_Decals.size();
+	}
+
+	void Clear()
+	{
+		// Decals reference their sprites
+		m_Decals.clear();
+		m_Sprites.clear();
+		m_Paths.clear();
+	}
+
+private:
+	std::vector<std::unique_ptr<olc::Decal>> m_Decals;
+
+	std::vector<std::unique_ptr<olc::Sprite>> m_Sprites;
+
+	std::unordered_map<std::string, ResourceHandle> m_Paths;
+};
+
+extern ResourceTable g_Resources;
@@ -0,0 +1,173 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+#include "ECS.h"
+
+// Resident set size of this process, 0 where it can't be read
+inline uint64_t GetResidentBytes()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters{};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.WorkingSetSize;
+	return 0;
+#elif defined(__linux__)
+	uint64_t size = 0;
+	uint64_t resident = 0;
+	FILE* file = std::fopen("/proc/self/statm", "r");
+	if (file == nullptr)
+		return 0;
+	if (std::fscanf(file, "%lu %lu", &size, &resident) != 2)
+		resident = 0;
+	std::fclose(file);
+	return resident * (uint64_t)sysconf(_SC_PAGESIZE);
+#else
+	return 0;
+#endif
+}
+
+struct SoakMetric
+{
+	std::string name;
+	// (seconds, value) pairs
+	std::vector<std::pair<double, double>> samples;
+};
+
+// Spawn-driven counts wander a few units either way, so a trend only counts
+// when its slope is this many standard errors from zero and the growth is
+// larger than this many standard deviations of the scatter around it
+const double SOAK_MIN_T = 5.0;
+const double SOAK_SWING_SIGMAS = 2.0;
+
+// Samples resource usage over a long run and flags anything whose fitted
+// trend grows by more than `tolerance` of its starting level
+class SoakMonitor
+{
+public:
+	explicit SoakMonitor(double tolerance = 0.1, double warmUp = 0.1)
+		: m_Tolerance(tolerance), m_WarmUp(warmUp)
+	{}
+
+	void Sample(double seconds, uint32_t textures, const EcsStats& stats)
+	{
+		Add("rss_bytes", seconds, (double)GetResidentBytes());
+		Add("living_entities", seconds, stats.livingEntities);
+		Add("textures", seconds, textures);
+		for (auto const& pool : stats.pools)
+		{
+			Add(std::string("pool:") + pool.name, seconds, (double)pool.size);
+		}
+	}
+
+	// Records a single sample of any metric, Sample() goes through here
+	void Add(const std::string& name, double seconds, double value)
+	{
+		auto it = std::find_if(m_Metrics.begin(), m_Metrics.end(), [&](SoakMetric const& metric) { return metric.name == name; });
+		if (it == m_Metrics.end())
+		{
+			m_Metrics.push_back(SoakMetric{ name });
+			it = m_Metrics.end() - 1;
+		}
+		it->samples.emplace_back(seconds, value);
+	}
+
+	// Writes one JSON object per metric and returns false if any of them grew
+	bool Report(std::ostream& out) const
+	{
+		bool passed = true;
+
+		out << "{ \"tolerance\": " << m_Tolerance << ", \"metrics\": [";
+		for (size_t i = 0; i < m_Metrics.size(); i++)
+		{
+			auto const& metric = m_Metrics[i];
+
+			// Startup allocations and the first waves of enemies aren't a trend
+			size_t first = (size_t)(metric.samples.size() * m_WarmUp);
+			auto begin = metric.samples.begin() + first;
+			auto end = metric.samples.end();
+			size_t count = end - begin;
+
+			double slope = 0.0;
+			double meanValue = 0.0;
+			double duration = 0.0;
+			// Standard deviation of the samples around the fitted line, and the slope's standard error
+			double residual = 0.0;
+			double slopeError = 0.0;
+			if (count >= 2)
+			{
+				double meanTime = 0.0;
+				for (auto it = begin; it != end; ++it)
+				{
+					meanTime += it->first;
+					meanValue += it->second;
+				}
+				meanTime /= count;
+				meanValue /= count;
+
+				double covariance = 0.0;
+				double variance = 0.0;
+				for (auto it = begin; it != end; ++it)
+				{
+					covariance += (it->first - meanTime) * (it->second - meanValue);
+					variance += (it->first - meanTime) * (it->first - meanTime);
+				}
+				slope = variance > 0.0 ? covariance / variance : 0.0;
+				duration = (end - 1)->first - begin->first;
+
+				if (count > 2 && variance > 0.0)
+				{
+					double squares = 0.0;
+					for (auto it = begin; it != end; ++it)
+					{
+						double error = it->second - (meanValue + slope * (it->first - meanTime));
+						squares += error * error;
+					}
+					residual = std::sqrt(squares / (count - 2));
+					slopeError = residual / std::sqrt(variance);
+				}
+			}
+
+			// Growth over the measured window compared with the level at its start,
+			// with a floor of one unit so metrics sitting at zero can't fail on noise
+			double growth = slope * duration;
+			double start = count > 0 ? std::max(meanValue - growth * 0.5, 0.0) : 0.0;
+			// Two samples say nothing about the scatter. With more, a perfectly
+			// straight climb has none, which is as significant as it gets.
+			bool significant = count > 2 && (slopeError > 0.0 ? slope > SOAK_MIN_T * slopeError : slope > 0.0);
+			bool grew = significant && growth > std::max({ start * m_Tolerance, SOAK_SWING_SIGMAS * residual, 1.0 });
+			passed = passed && !grew;
+
+			out << (i > 0 ? ", " : "") << "{ \"name\": \"" << metric.name << "\""
+				<< ", \"samples\": " << count
+				<< ", \"start\": " << start
+				<< ", \"growth\": " << growth
+				<< ", \"per_hour\": " << slope * 3600.0
+				<< ", \"residual\": " << residual
+				<< ", \"t\": " << (slopeError > 0.0 ? slope / slopeError : 0.0)
+				<< ", \"grew\": " << (grew ? "true" : "false") << " }";
+		}
+		out << "], \"passed\": " << (passed ? "true" : "false") << " }";
+
+		return passed;
+	}
+
+private:
+	std::vector<SoakMetric> m_Metrics;
+
+	double m_Tolerance;
+
+	double m_WarmUp;
+};
@@ -0,0 +1,59 @@
+/*
+	Checks the soak monitor's growth detection against synthetic series, a
+	pool that only wanders around its level must pass and a leak must fail.
+
+	g++ -o SoakTest SoakTest.cpp -O2 -DOLC_PLATFORM_HEADLESS -DOLC_GFX_NULL -lpthread -lpng -std=c++20
+
+	./SoakTest
+*/
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+#include <iostream>
+#include <random>
+#include <sstream>
+#include "Soak.h"
+
+static bool Check(const char* name, bool passed, bool expected)
+{
+	std::cout << (passed == expected ? "ok   " : "FAIL ") << name << std::endl;
+	return passed == expected;
+}
+
+// Two minute run sampled every ten seconds, the same shape as --soak 2
+static bool RunSeries(const char* name, double level, double swing, double perMinute, uint32_t seed, uint32_t samples = 13)
+{
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<double> noise(-swing, swing);
+
+	SoakMonitor monitor;
+	for (uint32_t i = 0; i < samples; ++i)
+	{
+		double seconds = i * 10.0;
+		monitor.Add(name, seconds, std::round(level + perMinute * seconds / 60.0 + noise(random)));
+	}
+
+	std::ostringstream report;
+	return monitor.Report(report);
+}
+
+int main()
+{
+	bool ok = true;
+
+	// Enemy and bullet counts bounce around a steady level
+	for (uint32_t seed = 1; seed <= 32; ++seed)
+	{
+		ok &= Check(("flat noisy series, seed " + std::to_string(seed)).c_str(), RunSeries("pool:AI", 15.0, 5.0, 0.0, seed), true);
+	}
+	ok &= Check("flat series", RunSeries("textures", 12.0, 0.0, 0.0, 1), true);
+	ok &= Check("empty pool", RunSeries("pool:Bullet", 0.0, 0.0, 0.0, 1), true);
+	ok &= Check("two samples", RunSeries("pool:Bullet", 3.0, 5.0, 20.0, 1, 2), true);
+
+	// Entities that are never destroyed
+	ok &= Check("steady leak", RunSeries("living_entities", 20.0, 0.0, 5.0, 1), false);
+	ok &= Check("noisy leak", RunSeries("living_entities", 20.0, 3.0, 20.0, 1), false);
+	ok &= Check("slow leak over a long run", RunSeries("living_entities", 20.0, 5.0, 0.5, 1, 180), false);
+
+	std::cout << (ok ? "all passed" : "failures") << std::endl;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "ECS.h"
+
+// Buckets entities with a Transform and a Collision by the grid cell their
+// position falls in. Cells hash into a fixed bucket table, so the world is
+// unbounded and nothing allocates. Moving within a cell costs a compare, only
+// crossing into another cell relinks the entity.
+const float SPATIAL_CELL_SIZE = 16.0f;
+const size_t SPATIAL_BUCKETS = 4096;
+static_assert((SPATIAL_BUCKETS & (SPATIAL_BUCKETS - 1)) == 0, "SPATIAL_BUCKETS must be a power of two.");
+
+class SpatialGrid
+{
+public:
+	static constexpr Entity NONE = NULL_ENTITY;
+
+	SpatialGrid()
+	{
+		m_Heads.fill(NONE);
+		m_Buckets.fill(NONE);
+	}
+
+	bool Contains(Entity entity) const
+	{
+		return m_Buckets[entity] != NONE;
+	}
+
+	void Insert(Entity entity, olc::vf2d position, float radius)
+	{
+		assert(!Contains(entity) && "Entity already in spatial index.");
+
+		m_MaxRadius = std::max(m_MaxRadius, radius);
+		Link(entity, CellOf(position));
+		++m_Size;
+	}
+
+	void Remove(Entity entity)
+	{
+		assert(Contains(entity) && "Removing entity missing from spatial index.");
+
+		Unlink(entity);
+		--m_Size;
+	}
+
+	void Move(Entity entity, olc::vf2d position)
+	{
+		assert(Contains(entity) && "Moving entity missing from spatial index.");
+
+		++m_Moves;
+		uint64_t cell = CellOf(position);
+		if (cell != m_Cells[entity])
+		{
+			Unlink(entity);
+			Link(entity, cell);
+			++m_Rebuckets;
+		}
+	}
+
+	// Calls f(entity) for every entity in a cell that a circle of `radius` around
+	// `position` could overlap, allowing for the largest collider inserted
+	template<typename F>
+	void Query(olc::vf2d position, float radius, F&& f) const
+	{
+		float reach = radius + m_MaxRadius;
+		int32_t x0 = CellCoord(position.x - reach);
+		int32_t x1 = CellCoord(position.x + reach);
+		int32_t y0 = CellCoord(position.y - reach);
+		int32_t y1 = CellCoord(position.y + reach);
+
+		for (int32_t y = y0; y <= y1; y++)
+		{
+			for (int32_t x = x0; x <= x1; x++)
+			{
+				uint64_t cell = PackCell(x, y);
+				// Other cells can hash to the same bucket
+				for (Entity entity = m_Heads[BucketOf(cell)]; entity != NONE; entity = m_Next[entity])
+				{
+					if (m_Cells[entity] == cell)
+						f(entity);
+				}
+			}
+		}
+	}
+
+	size_t Size() const
+	{
+		return m_Size;
+	}
+
+	// Moves seen, and how many of them crossed into another cell
+	uint64_t GetMoves() const
+	{
+		return m_Moves;
+	}
+
+	uint64_t GetRebuckets() const
+	{
+		return m_Rebuckets;
+	}
+
+private:
+	// Bucket chains, doubly linked through the per-entity arrays
+	std::array<Entity, SPATIAL_BUCKETS> m_Heads;
+
+	std::array<Entity, MAX_ENTITIES> m_Next{};
+
+	std::array<Entity, MAX_ENTITIES> m_Previous{};
+
+	std::array<uint64_t, MAX_ENTITIES> m_Cells{};
+
+	// NONE while the entity isn't indexed
+	std::array<uint32_t, MAX_ENTITIES> m_Buckets;
+
+	float m_MaxRadius{};
+
+	size_t m_Size{};
+
+	uint64_t m_Moves{};
+
+	uint64_t m_Rebuckets{};
+
+	static int32_t CellCoord(float value)
+	{
+		return (int32_t)std::floor(value / SPATIAL_CELL_SIZE);
+	}
+
+	static uint64_t PackCell(int32_t x, int32_t y)
+	{
+		return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+	}
+
+	static uint64_t CellOf(olc::vf2d position)
+	{
+		return PackCell(CellCoord(position.x), CellCoord(position.y));
+	}
+
+	static uint32_t BucketOf(uint64_t cell)
+	{
+		return (uint32_t)((cell * 0x9E3779B97F4A7C15ull) >> 32) & (SPATIAL_BUCKETS - 1);
+	}
+
+	void Link(Entity entity, uint64_t cell)
+	{
+		uint32_t bucket = BucketOf(cell);
+		Entity head = m_Heads[bucket];
+
+		m_Cells[entity] = cell;
+		m_Buckets[entity] = bucket;
+		m_Previous[entity] = NONE;
+		m_Next[entity] = head;
+		if (head != NONE)
+			m_Previous[head] = entity;
+		m_Heads[bucket] = entity;
+	}
+
+	void Unlink(Entity entity)
+	{
+		Entity previous = m_Previous[entity];
+		Entity next = m_Next[entity];
+
+		if (previous != NONE)
+			m_Next[previous] = next;
+		else
+			m_Heads[m_Buckets[entity]] = next;
+		if (next != NONE)
+			m_Previous[next] = previous;
+
+		m_Buckets[entity] = NONE;
+	}
+};
+
+// Keeps `index` in step with every entity that has a Transform and a
+// Collision, starting with the ones that already exist. Later adds and
+// removals reach it through observers, so it catches up at FlushObservers.
+// Moves are not tracked here, the owner calls SpatialGrid::Move as entities
+// move. Attach an index once per Init, observers can't be taken off again.
+inline void TrackSpatialIndex(Coordinator& coordinator, SpatialGrid& index)
+{
+	auto insert = [&coordinator, &index](std::span<const Entity> entities)
+	{
+		for (Entity entity : entities)
+		{
+			if (!index.Contains(entity) && coordinator.HasComponent<Transform>(entity) && coordinator.HasComponent<Collision>(entity))
+			{
+				index.Insert(entity, coordinator.ReadComponent<Transform>(entity).position, coordinator.ReadComponent<Collision>(entity).radius);
+			}
+		}
+	};
+	auto remove = [&index](std::span<const Entity> entities)
+	{
+		for (Entity entity : entities)
+		{
+			if (index.Contains(entity))
+			{
+				index.Remove(entity);
+			}
+		}
+	};
+
+	coordinator.OnAdd<Transform>(insert);
+	coordinator.OnAdd<Collision>(insert);
+	coordinator.OnRemove<Transform>(remove);
+	coordinator.OnRemove<Collision>(remove);
+
+	SystemFilter filter;
+	filter.all.set(coordinator.GetComponentType<Transform>());
+	filter.all.set(coordinator.GetComponentType<Collision>());
+
+	std::vector<Entity> entities;
+	coordinator.Query(filter, entities);
+	insert(entities);
+}
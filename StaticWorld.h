@@ -0,0 +1,338 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+#include "ECS.h"
+#include "TypeList.h"
+
+// A world whose component and system sets are fixed at compile time.
+// Component indices, system signatures and membership tests are all
+// constexpr, pools live in a std::tuple and nothing is virtual, looked up
+// by name or reference counted, so a whole frame can be inlined.
+//
+//	struct MoveSystem { using Components = ComponentList<Transform, AI>; };
+//	using World = StaticWorld<ComponentList<Transform, AI>, SystemList<MoveSystem>>;
+//
+// A system may also declare `using Exclude = ComponentList<...>;` to skip
+// entities that have any of those components.
+//
+// Every pool is sized for MAX_ENTITIES up front, allocate worlds on the heap.
+
+template<typename... Components>
+using ComponentList = TypeList<Components...>;
+
+template<typename... Systems>
+using SystemList = TypeList<Systems...>;
+
+// Dense list of entities with an index back into it, so membership tests,
+// inserts and swap-removes are all constant time and never allocate
+class EntitySet
+{
+public:
+	bool Contains(Entity entity) const
+	{
+		uint32_t index = m_Index[entity];
+		return index < m_Size && m_Dense[index] == entity;
+	}
+
+	size_t IndexOf(Entity entity) const
+	{
+		assert(Contains(entity) && "Entity not in set.");
+
+		return m_Index[entity];
+	}
+
+	size_t Insert(Entity entity)
+	{
+		assert(!Contains(entity) && "Entity already in set.");
+
+		m_Index[entity] = (uint32_t)m_Size;
+		m_Dense[m_Size] = entity;
+		return m_Size++;
+	}
+
+	// Moves the last entity into the hole and returns the hole's index
+	size_t Remove(Entity entity)
+	{
+		size_t hole = IndexOf(entity);
+		Entity last = m_Dense[--m_Size];
+		m_Dense[hole] = last;
+		m_Index[last] = (uint32_t)hole;
+		return hole;
+	}
+
+	size_t Size() const
+	{
+		return m_Size;
+	}
+
+	std::span<const Entity> Entities() const
+	{
+		return { m_Dense.data(), m_Size };
+	}
+
+private:
+	std::array<uint32_t, MAX_ENTITIES> m_Index{};
+
+	std::array<Entity, MAX_ENTITIES> m_Dense{};
+
+	size_t m_Size{};
+};
+
+template<typename T>
+class StaticPool
+{
+public:
+	template<typename... Args>
+	T& Emplace(Entity entity, Args&&... args)
+	{
+		T* slot = &m_Data[m_Entities.Insert(entity)];
+		std::destroy_at(slot);
+		std::construct_at(slot, std::forward<Args>(args)...);
+		return *slot;
+	}
+
+	void Remove(Entity entity)
+	{
+		size_t hole = m_Entities.Remove(entity);
+		size_t last = m_Entities.Size();
+		if (hole != last)
+		{
+			m_Data[hole] = std::move(m_Data[last]);
+		}
+	}
+
+	T& Get(Entity entity)
+	{
+		return m_Data[m_Entities.IndexOf(entity)];
+	}
+
+	bool Contains(Entity entity) const
+	{
+		return m_Entities.Contains(entity);
+	}
+
+	size_t Size() const
+	{
+		return m_Entities.Size();
+	}
+
+private:
+	std::array<T, MAX_ENTITIES> m_Data{};
+
+	EntitySet m_Entities;
+};
+
+template<typename ComponentList, typename SystemList>
+class StaticWorld;
+
+template<typename... Cs, typename... Ss>
+class StaticWorld<TypeList<Cs...>, TypeList<Ss...>>
+{
+public:
+	static_assert(sizeof...(Cs) <= MAX_COMPONENTS, "Too many component types, raise ECS_SIGNATURE_BITS.");
+
+	template<typename T>
+	static constexpr ComponentType GetComponentType()
+	{
+		constexpr size_t index = TypeIndex<T, Cs...>();
+		static_assert(index < sizeof...(Cs), "Component is not part of this world.");
+		return (ComponentType)index;
+	}
+
+	template<typename... Ts>
+	static constexpr Signature MakeSignature(TypeList<Ts...> = {})
+	{
+		Signature signature;
+		(signature.set(GetComponentType<Ts>()), ...);
+		return signature;
+	}
+
+	template<typename S>
+	static constexpr SystemFilter GetSystemFilter()
+	{
+		SystemFilter filter{ .all = MakeSignature(typename S::Components{}) };
+		if constexpr (requires { typename S::Exclude; })
+		{
+			filter.none = MakeSignature(typename S::Exclude{});
+		}
+		return filter;
+	}
+
+	StaticWorld()
+	{
+		for (Entity entity = 0; entity < MAX_ENTITIES; entity++)
+		{
+			m_AvailableEntities[entity] = MAX_ENTITIES - 1 - entity;
+		}
+	}
+
+	Entity CreateEntity()
+	{
+		assert(m_LivingEntityCount < MAX_ENTITIES && "Too many entities in existence.");
+
+		++m_LivingEntityCount;
+		return m_AvailableEntities[MAX_ENTITIES - m_LivingEntityCount];
+	}
+
+	void DestroyEntity(Entity entity)
+	{
+		assert(entity < MAX_ENTITIES && "Entity out of range.");
+
+		Signature signature = m_Signatures[entity];
+		(RemoveIfPresent<Cs>(entity, signature), ...);
+		(LeaveIfMember<Ss>(entity, signature), ...);
+
+		m_Signatures[entity].reset();
+		m_AvailableEntities[MAX_ENTITIES - m_LivingEntityCount] = entity;
+		--m_LivingEntityCount;
+	}
+
+	template<typename T>
+	void AddComponent(Entity entity, T&& component)
+	{
+		EmplaceComponent<std::remove_cvref_t<T>>(entity, std::forward<T>(component));
+	}
+
+	template<typename T, typename... Args>
+	T& EmplaceComponent(Entity entity, Args&&... args)
+	{
+		T& component = GetPool<T>().Emplace(entity, std::forward<Args>(args)...);
+		m_Signatures[entity].set(GetComponentType<T>());
+		SignatureChanged(entity);
+		return component;
+	}
+
+	template<typename T>
+	void RemoveComponent(Entity entity)
+	{
+		GetPool<T>().Remove(entity);
+		m_Signatures[entity].reset(GetComponentType<T>());
+		SignatureChanged(entity);
+	}
+
+	template<typename T>
+	T& GetComponent(Entity entity)
+	{
+		return GetPool<T>().Get(entity);
+	}
+
+	template<typename T>
+	bool HasComponent(Entity entity) const
+	{
+		return m_Signatures[entity].test(GetComponentType<T>());
+	}
+
+	const Signature& GetSignature(Entity entity) const
+	{
+		return m_Signatures[entity];
+	}
+
+	uint32_t GetLivingEntityCount() const
+	{
+		return m_LivingEntityCount;
+	}
+
+	template<typename S>
+	std::span<const Entity> GetEntities() const
+	{
+		return GetMembers<S>().Entities();
+	}
+
+	// Calls f(entity, components...) with S's components for every member of S.
+	// Walks backwards so f may destroy the entity it was given.
+	template<typename S, typename F>
+	void ForEach(F&& f)
+	{
+		ForEach<S>(std::forward<F>(f), typename S::Components{});
+	}
+
+private:
+	std::tuple<StaticPool<Cs>...> m_Pools;
+
+	// One member set per system, in SystemList order
+	std::tuple<decltype((void)sizeof(Ss), EntitySet{})...> m_Members;
+
+	std::array<Signature, MAX_ENTITIES> m_Signatures{};
+
+	// Used as a stack, free IDs sit below MAX_ENTITIES - m_LivingEntityCount
+	std::array<Entity, MAX_ENTITIES> m_AvailableEntities{};
+
+	uint32_t m_LivingEntityCount{};
+
+	template<typename T>
+	StaticPool<T>& GetPool()
+	{
+		return std::get<GetComponentType<T>()>(m_Pools);
+	}
+
+	template<typename S>
+	EntitySet& GetMembers()
+	{
+		constexpr size_t index = TypeIndex<S, Ss...>();
+		static_assert(index < sizeof...(Ss), "System is not part of this world.");
+		return std::get<index>(m_Members);
+	}
+
+	template<typename S>
+	const EntitySet& GetMembers() const
+	{
+		return const_cast<StaticWorld*>(this)->GetMembers<S>();
+	}
+
+	template<typename T>
+	void RemoveIfPresent(Entity entity, const Signature& signature)
+	{
+		if (signature.test(GetComponentType<T>()))
+		{
+			GetPool<T>().Remove(entity);
+		}
+	}
+
+	template<typename S>
+	void LeaveIfMember(Entity entity, const Signature& signature)
+	{
+		constexpr SystemFilter filter = GetSystemFilter<S>();
+		if (filter.Matches(signature))
+		{
+			GetMembers<S>().Remove(entity);
+		}
+	}
+
+	void SignatureChanged(Entity entity)
+	{
+		(UpdateMembership<Ss>(entity, m_Signatures[entity]), ...);
+	}
+
+	template<typename S>
+	void UpdateMembership(Entity entity, const Signature& signature)
+	{
+		constexpr SystemFilter filter = GetSystemFilter<S>();
+		auto& members = GetMembers<S>();
+
+		bool matches = filter.Matches(signature);
+		if (matches && !members.Contains(entity))
+		{
+			members.Insert(entity);
+		}
+		else if (!matches && members.Contains(entity))
+		{
+			members.Remove(entity);
+		}
+	}
+
+	template<typename S, typename F, typename... Ts>
+	void ForEach(F&& f, TypeList<Ts...>)
+	{
+		auto& members = GetMembers<S>();
+		for (size_t index = members.Size(); index-- > 0;)
+		{
+			Entity entity = members.Entities()[index];
+			f(entity, GetComponent<Ts>(entity)...);
+		}
+	}
+};
@@ -0,0 +1,279 @@
+#include "olcPixelGameEngine.h"
+#include "ECS.h"
+#include "Systems.h"
+#include "Profiler.h"
+#include "Resources.h"
+#include "Events.h"
+#include "CommandQueue.h"
+
+Coordinator g_Coordinator;
+ResourceTable g_Resources;
+GameEvents g_Events;
+CommandQueue g_Commands;
+Profiler g_Profiler;
+PerfCounters g_PerfCounters;
+
+void PhysicsSystem::Update(float deltaTime, olc::PixelGameEngine* engine)
+{
+	auto rigidBodies = g_Coordinator.WriteScope<RigidBody>();
+	auto transforms = g_Coordinator.WriteScope<Transform>();
+
+	for (auto const& entity : m_Entities)
+	{
+		auto& rigidBody = g_Coordinator.GetComponent<RigidBody>(entity);
+		auto& transform = g_Coordinator.GetComponent<Transform>(entity);
+		auto const& gravity = g_Coordinator.ReadComponent<Gravity>(entity);
+
+		transform.position += rigidBody.velocity * deltaTime;
+
+		rigidBody.velocity += gravity.force * deltaTime;
+
+		if (transform.position.y <= -5.0f)
+		{
+			g_Commands.Destroy(entity);
+		}
+	}
+}
+
+void RenderSystem::Render(olc::PixelGameEngine* engine)
+{
+	engine->Clear(olc::BLANK);
+
+	auto graphics = g_Coordinator.WriteScope<Graphic>();
+	for (auto const& entity : m_Entities)
+	{
+		auto const& transform = g_Coordinator.ReadComponent<Transform>(entity);
+		auto& graphic = g_Coordinator.GetComponent<Graphic>(entity);
+		auto const& collision = g_Coordinator.ReadComponent<Collision>(entity);
+
+		graphic.tint = collision.isCollision ? olc::DARK_RED : olc::WHITE;
+		engine->DrawDecal(transform.position, g_Resources.GetDecal(graphic.decal), transform.scale, graphic.tint);
+
+		//Draw collision circle
+		//engine->DrawCircle(transform.position + collision.center, collision.radius, collision.isCollision ? olc::GREEN : olc::WHITE);
+	}
+}
+
+void MovementSystem::OnMove(olc::vf2d direction)
+{
+	auto transforms = g_Coordinator.WriteScope<Transform>();
+
+	for (auto const& entity : m_Entities)
+	{
+		auto& transfrom = g_Coordinator.GetComponent<Transform>(entity);
+		auto const& input = g_Coordinator.ReadComponent<Input>(entity);
+
+		transfrom.position += direction * input.speed;
+	}
+}
+
+Entity CollisionSystem::CheckCollision(Entity entity)
+{
+	auto const& transform1 = g_Coordinator.ReadComponent<Transform>(entity);
+	auto& collision1 = g_Coordinator.GetComponent<Collision>(entity);
+
+	Entity hit = SpatialGrid::NONE;
+
+	// Only entities in neighbouring cells can be close enough to collide
+	collision1.isCollision = false;
+	m_Grid.Query(transform1.position, collision1.radius, [&](Entity other)
+	{
+		if (entity == other || collision1.isCollision)
+			return;
+
+		auto const& transform2 = g_Coordinator.ReadComponent<Transform>(other);
+		auto& collision2 = g_Coordinator.GetComponent<Collision>(other);
+
+		olc::vf2d pos1 = transform1.position;
+		olc::vf2d pos2 = transform2.position;
+		float radii = collision1.radius + collision2.radius;
+
+		collision1.isCollision = ((pos1.x - pos2.x) * (pos1.x - pos2.x) +
+								 (pos1.y - pos2.y) * (pos1.y - pos2.y)) <= radii * radii;
+
+		collision2.isCollision = collision1.isCollision;
+
+		if (collision1.isCollision)
+		{
+			hit = other;
+		}
+	});
+
+	return hit;
+}
+
+void CollisionSystem::CheckAllCollision()
+{
+	UpdateIndex();
+
+	auto collisions = g_Coordinator.WriteScope<Collision>();
+
+	for (auto const& entity : m_Entities)
+	{
+		if (CheckCollision(entity) != SpatialGrid::NONE)
+		{
+			return;
+		}
+	}
+}
+
+void CollisionSystem::Update()
+{
+	UpdateIndex();
+
+	auto collisions = g_Coordinator.WriteScope<Collision>();
+
+	// Every moved entity is in its new cell before any of them is checked
+	for (Entity entity : m_Changed)
+	{
+		if (!m_Grid.Contains(entity))
+			continue;
+
+		Entity other = CheckCollision(entity);
+		if (other != SpatialGrid::NONE)
+		{
+			g_Events.Emit(HitEvent{ entity, other });
+		}
+	}
+}
+
+void CollisionSystem::UpdateIndex()
+{
+	// The grid's observers only run at FlushObservers, entities spawned since
+	// then are inserted here so they collide on the frame they appear
+	m_Added.clear();
+	g_Coordinator.Query<Added<Transform>>(m_IndexTick, m_Added);
+	g_Coordinator.Query<Added<Collision>>(m_IndexTick, m_Added);
+	for (Entity entity : m_Added)
+	{
+		if (!m_Grid.Contains(entity) && g_Coordinator.HasComponent<Transform>(entity) && g_Coordinator.HasComponent<Collision>(entity))
+		{
+			m_Grid.Insert(entity, g_Coordinator.ReadComponent<Transform>(entity).position, g_Coordinator.ReadComponent<Collision>(entity).radius);
+		}
+	}
+
+	m_Changed.clear();
+	g_Coordinator.Query<Changed<Transform>>(m_IndexTick, m_Changed);
+
+	// Changes can still be made this tick, so look at it again next time
+	m_IndexTick = g_Coordinator.GetTick() - 1;
+
+	for (Entity entity : m_Changed)
+	{
+		if (m_Grid.Contains(entity))
+		{
+			m_Grid.Move(entity, g_Coordinator.ReadComponent<Transform>(entity).position);
+		}
+	}
+}
+
+void BulletSystem::MoveBullet(float deltaTime, olc::PixelGameEngine* engine)
+{
+	auto transforms = g_Coordinator.WriteScope<Transform>();
+
+	for (auto const& entity : m_Entities)
+	{
+		auto& transform = g_Coordinator.GetComponent<Transform>(entity);
+		auto const& bullet = g_Coordinator.ReadComponent<Bullet>(entity);
+		auto const& collision = g_Coordinator.ReadComponent<Collision>(entity);
+
+		transform.position += bullet.velocity * deltaTime;
+
+		//Destroy bullet if outside of game window
+		if (transform.position.y < -collision.radius || transform.position.y > engine->ScreenHeight() + collision.radius)
+		{
+			g_Commands.Destroy(entity);
+		}
+	}
+}
+
+void BulletSystem::ResolveHits()
+{
+	for (auto const& hit : g_Events.Get<HitEvent>())
+	{
+		if (m_Entities.contains(hit.entity))
+		{
+			g_Commands.Destroy(hit.entity);
+		}
+	}
+}
+
+void BulletSystem::SpawnBullets()
+{
+	olc::vf2d scale = olc::vf2d(0.1f, 0.1f);
+
+	// Only reserves IDs and queues commands, so it could run on a worker thread
+	for (auto const& shot : g_Events.Get<ShotFiredEvent>())
+	{
+		Entity entity = g_Coordinator.ReserveEntity();
+		if (entity == NULL_ENTITY)
+		{
+			m_DroppedShots.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
+
+		olc::Sprite* sprite = g_Resources.GetSprite(shot.decal);
+
+		g_Commands.Spawn(entity,
+						 Transform{ .position = shot.position, .scale = scale },
+						 Graphic{ .decal = shot.decal, .tint = olc::WHITE },
+						 Bullet{ .velocity = shot.velocity },
+						 Collision{ .radius = 2.0f,
+									.center = olc::vf2d(sprite->width * 0.5f,
+														sprite->height * 0.5f) * scale });
+	}
+}
+
+void AISystem::Move(float deltaTime, olc::PixelGameEngine* engine)
+{
+	auto transforms = g_Coordinator.WriteScope<Transform>();
+
+	for (auto const& entity : m_Entities)
+	{
+		auto& transform = g_Coordinator.GetComponent<Transform>(entity);
+		auto const& ai = g_Coordinator.ReadComponent<AI>(entity);
+		auto const& collision = g_Coordinator.ReadComponent<Collision>(entity);
+
+		transform.position += ai.velocity * deltaTime;
+
+		if (transform.position.y > engine->ScreenHeight() + collision.radius)
+		{
+			transform.position.y = -collision.radius * 2.0f;
+		}
+	}
+}
+
+void AISystem::ResolveHits()
+{
+	//Destroy enemy if collide
+	for (auto const& hit : g_Events.Get<HitEvent>())
+	{
+		if (m_Entities.contains(hit.entity))
+		{
+			g_Commands.Destroy(hit.entity);
+		}
+	}
+}
+
+void AISystem::Shoot(float deltaTime)
+{
+	auto ais = g_Coordinator.WriteScope<AI>();
+
+	for (auto const& entity : m_Entities)
+	{
+		auto& ai = g_Coordinator.GetComponent<AI>(entity);
+
+		ai.shootTimer += deltaTime;
+
+		if (ai.shootTimer >= ai.shootInterval)
+		{
+			auto const& transform = g_Coordinator.ReadComponent<Transform>(entity);
+
+			g_Events.Emit(ShotFiredEvent{ .position = transform.position + olc::vf2d(5.0f, 10.0f),
+										  .velocity = olc::vf2d(0.0f, ai.bulletSpeed),
+										  .decal = ai.bulletDecal });
+
+			ai.shootTimer -= ai.shootInterval;
+		}
+	}
+}
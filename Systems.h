@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <vector>
+
+#include "ECS.h"
+#include "SpatialGrid.h"
+
+class PhysicsSystem : public System
+{
+public:
+	void Update(float deltaTime, olc::PixelGameEngine* pge);
+};
+
+class RenderSystem : public System
+{
+public:
+	void Render(olc::PixelGameEngine* pge);
+};
+
+class MovementSystem : public System
+{
+public:
+	void OnMove(olc::vf2d direction);
+};
+
+class CollisionSystem : public System
+{
+public:
+	// Checks every entity whose Transform changed since the last call and
+	// sends a HitEvent for each one that overlaps another
+	void Update();
+
+	// Returns the entity it overlaps, or SpatialGrid::NONE
+	Entity CheckCollision(Entity entity);
+	void CheckAllCollision();
+
+	// Inserts entities spawned since the last call and re-buckets the ones
+	// whose Transform changed
+	void UpdateIndex();
+
+	SpatialGrid m_Grid;
+
+private:
+	Tick m_IndexTick{};
+
+	std::vector<Entity> m_Added;
+
+	std::vector<Entity> m_Changed;
+};
+
+class BulletSystem : public System
+{
+public:
+	void MoveBullet(float deltaTime, olc::PixelGameEngine* engine);
+	void ResolveHits();
+	void SpawnBullets();
+
+	// Shots skipped because every entity was in use
+	std::atomic<uint64_t> m_DroppedShots{};
+};
+
+class AISystem : public System
+{
+public:
+	void Move(float deltaTime, olc::PixelGameEngine* engine);
+	void ResolveHits();
+	void Shoot(float deltaTime);
+};
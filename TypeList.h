@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+
+// Compile-time lists of types, shared by the static world and the event bus
+
+template<typename... Ts>
+struct TypeList
+{};
+
+// Position of T in Ts, or sizeof...(Ts) when it isn't there
+template<typename T, typename... Ts>
+constexpr size_t TypeIndex()
+{
+	constexpr bool matches[] = { std::is_same_v<T, Ts>... };
+	for (size_t index = 0; index < sizeof...(Ts); index++)
+	{
+		if (matches[index])
+			return index;
+	}
+	return sizeof...(Ts);
+}
@@ -80,6 +80,14 @@
 
 	vblank_mode=0 ./YourProgName
 
+	Running Headless
+	~~~~~~~~~~~~~~~~
+	For build servers and simulation-only runs the engine can be compiled
+	without a window or graphics context. Input is then supplied by a script
+	through olc::Platform_Headless::funcInput:
+
+	g++ -o YourProgName YourSource.cpp -DOLC_PLATFORM_HEADLESS -DOLC_GFX_NULL -lpthread -lpng -std=c++17
+
 
 	Compiling in Code::Blocks on Windows
 	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -316,7 +324,7 @@ int main()
 // O------------------------------------------------------------------------------O
 
 // Platform
-#if !defined(OLC_PLATFORM_WINAPI) && !defined(OLC_PLATFORM_X11) && !defined(OLC_PLATFORM_GLUT)
+#if !defined(OLC_PLATFORM_WINAPI) && !defined(OLC_PLATFORM_X11) && !defined(OLC_PLATFORM_GLUT) && !defined(OLC_PLATFORM_HEADLESS)
 	#if defined(_WIN32)
 		#define OLC_PLATFORM_WINAPI
 	#endif
@@ -329,7 +337,7 @@ int main()
 #endif
 
 // Renderer
-#if !defined(OLC_GFX_OPENGL10) || !defined(OLC_GFX_OPENGL33) && !defined(OLC_GFX_DIRECTX10)
+#if !defined(OLC_GFX_OPENGL10) && !defined(OLC_GFX_OPENGL33) && !defined(OLC_GFX_DIRECTX10) && !defined(OLC_GFX_NULL)
 	#define OLC_GFX_OPENGL10
 #endif
 
@@ -486,7 +494,7 @@ namespace olc
 		T y = 0;
 		v2d_generic() : x(0), y(0) {}
 		v2d_generic(T _x, T _y) : x(_x), y(_y) {}
-		v2d_generic(const v2d_generic& v) : x(v.x), y(v.y) {}
+		v2d_generic(const v2d_generic& v) = default;
 		v2d_generic& operator=(const v2d_generic& v) = default;
 		T mag() const { return T(std::sqrt(x * x + y * y)); }
 		T mag2() const { return x * x + y * y; }
@@ -550,6 +558,64 @@ namespace olc
 
 
 
+	// O------------------------------------------------------------------------------O
+	// | olc::FrameTimeHistogram - Distribution of frame times, in fixed width buckets|
+	// O------------------------------------------------------------------------------O
+	class FrameTimeHistogram
+	{
+	public:
+		// 0.1ms buckets up to 100ms, the last one also holds every slower frame
+		static constexpr size_t nBuckets = 1000;
+		static constexpr float fBucketWidth = 0.0001f;
+
+	public:
+		void Add(float fSeconds)
+		{
+			size_t nBucket = std::min(size_t(std::max(fSeconds, 0.0f) / fBucketWidth), nBuckets - 1);
+			nCounts[nBucket]++;
+			nCount++;
+			fTotal += fSeconds;
+			fMax = std::max(fMax, fSeconds);
+		}
+
+		void Reset()
+		{ *this = FrameTimeHistogram(); }
+
+		uint64_t GetCount() const
+		{ return nCount; }
+
+		float GetMean() const
+		{ return nCount > 0 ? float(fTotal / double(nCount)) : 0.0f; }
+
+		float GetMax() const
+		{ return fMax; }
+
+		// Upper edge of the bucket the p-th fraction of frames falls in, p from 0 to 1
+		float GetPercentile(float p) const
+		{
+			if (nCount == 0) return 0.0f;
+			uint64_t nRank = std::min(uint64_t(p * float(nCount)), nCount - 1);
+			uint64_t nSeen = 0;
+			for (size_t i = 0; i < nBuckets; i++)
+			{
+				nSeen += nCounts[i];
+				if (nSeen > nRank) return std::min(float(i + 1) * fBucketWidth, fMax);
+			}
+			return fMax;
+		}
+
+		const std::array<uint32_t, nBuckets>& GetBuckets() const
+		{ return nCounts; }
+
+	private:
+		std::array<uint32_t, nBuckets> nCounts{};
+		uint64_t nCount = 0;
+		double fTotal = 0.0;
+		float fMax = 0.0f;
+	};
+
+
+
 	// O------------------------------------------------------------------------------O
 	// | olc::ResourcePack - A virtual scrambled filesystem to pack your assets into  |
 	// O------------------------------------------------------------------------------O
@@ -725,6 +791,8 @@ namespace olc
 		virtual void       UpdateViewport(const olc::vi2d& pos, const olc::vi2d& size) = 0;
 		virtual void       ClearBuffer(olc::Pixel p, bool bDepth) = 0;
 		static olc::PixelGameEngine* ptrPGE;
+		// Textures currently alive on the device, for spotting leaks
+		static uint32_t nTextureCount;
 	};
 
 	class Platform
@@ -806,6 +874,8 @@ namespace olc
 		void SetDrawTarget(Sprite* target);
 		// Gets the current Frames Per Second
 		uint32_t GetFPS() const;
+		// Gets the number of textures currently created on the renderer
+		uint32_t GetTextureCount() const;
 		// Gets last update of elapsed time
 		float GetElapsedTime() const;
 		// Gets Actual Window size
@@ -918,6 +988,21 @@ namespace olc
 		// Clears the rendering back buffer
 		void ClearBuffer(Pixel p, bool bDepth = true);
 
+	public: // Frame pacing
+		// Caps the frame rate, 0 runs as fast as possible. Each frame sleeps until
+		// shortly before it is due, then spins the rest of the way, so frames start
+		// on time without sleep's coarse wake ups and without burning a core.
+		void SetTargetFrameRate(float fFrameRate);
+		float GetTargetFrameRate() const;
+		// Every frame's elapsed time since Start() or the last reset
+		const olc::FrameTimeHistogram& GetFrameTimeHistogram() const;
+		void ResetFrameTimeHistogram();
+
+	public: // Profiling
+		// Receives the start and end of each internal phase of a frame: "OnUserUpdate",
+		// "LayerUpload", "DecalDraw" and "DisplayFrame". Pass nullptr to stop.
+		void SetCorePhaseHook(std::function<void(const char* sPhase, std::chrono::steady_clock::time_point tpStart, std::chrono::steady_clock::time_point tpEnd)> f);
+
 	public: // Branding
 		std::string sAppName;
 
@@ -954,7 +1039,13 @@ namespace olc
 		bool        bPixelCohesion = false;
 		DecalMode   nDecalMode = DecalMode::NORMAL;
 		std::function<olc::Pixel(const int x, const int y, const olc::Pixel&, const olc::Pixel&)> funcPixelMode;
-		std::chrono::time_point<std::chrono::system_clock> m_tp1, m_tp2;
+		std::chrono::time_point<std::chrono::steady_clock> m_tp1, m_tp2;
+		float		fTargetFrameRate = 0.0f;
+		std::chrono::steady_clock::time_point tpNextFrame;
+		// How far ahead of a frame sleeping stops, grows to the worst oversleep seen
+		std::chrono::steady_clock::duration dSleepMargin = std::chrono::milliseconds(1);
+		olc::FrameTimeHistogram frameTimes;
+		std::function<void(const char*, std::chrono::steady_clock::time_point, std::chrono::steady_clock::time_point)> funcCorePhaseHook;
 		std::vector<olc::vi2d> vFontSpacing;
 
 		// State of keyboard		
@@ -970,6 +1061,8 @@ namespace olc
 		// The main engine thread
 		void		EngineThread();
 
+		void		olc_LimitFrameRate();
+
 		// At the very end of this file, chooses which
 		// components to compile
 		void        olc_ConfigureSystem();
@@ -1333,6 +1426,7 @@ namespace olc
 		if (spr == nullptr) return;
 		sprite = spr;
 		id = renderer->CreateTexture(sprite->width, sprite->height, filter);
+		Renderer::nTextureCount++;
 		Update();
 	}
 
@@ -1349,6 +1443,7 @@ namespace olc
 		if (id != -1)
 		{
 			renderer->DeleteTexture(id);
+			Renderer::nTextureCount--;
 			id = -1;
 		}
 	}
@@ -1707,6 +1802,7 @@ namespace olc
 		LayerDesc ld;
 		ld.pDrawTarget = new olc::Sprite(vScreenSize.x, vScreenSize.y);
 		ld.nResID = renderer->CreateTexture(vScreenSize.x, vScreenSize.y);
+		Renderer::nTextureCount++;
 		renderer->UpdateTexture(ld.nResID, ld.pDrawTarget);
 		vLayers.push_back(ld);
 		return uint32_t(vLayers.size()) - 1;
@@ -1734,6 +1830,9 @@ namespace olc
 	uint32_t PixelGameEngine::GetFPS() const
 	{ return nLastFPS; }
 
+	uint32_t PixelGameEngine::GetTextureCount() const
+	{ return Renderer::nTextureCount; }
+
 	bool PixelGameEngine::IsFocused() const
 	{ return bHasInputFocus; }
 
@@ -2785,6 +2884,9 @@ namespace olc
 		// Create user resources as part of this thread
 		if (!OnUserCreate()) bAtomActive = false;
 
+		// Loading isn't part of the first frame
+		m_tp1 = std::chrono::steady_clock::now();
+
 		while (bAtomActive)
 		{
 			// Run as fast as possible
@@ -2801,6 +2903,45 @@ namespace olc
 		platform->ThreadCleanUp();
 	}
 
+	void PixelGameEngine::SetTargetFrameRate(float fFrameRate)
+	{ fTargetFrameRate = std::max(fFrameRate, 0.0f); }
+
+	float PixelGameEngine::GetTargetFrameRate() const
+	{ return fTargetFrameRate; }
+
+	const olc::FrameTimeHistogram& PixelGameEngine::GetFrameTimeHistogram() const
+	{ return frameTimes; }
+
+	void PixelGameEngine::ResetFrameTimeHistogram()
+	{ frameTimes.Reset(); }
+
+	void PixelGameEngine::olc_LimitFrameRate()
+	{
+		if (fTargetFrameRate <= 0.0f) return;
+
+		auto tpNow = std::chrono::steady_clock::now();
+		if (tpNow < tpNextFrame)
+		{
+			auto tpWake = tpNextFrame - dSleepMargin;
+			if (tpNow < tpWake)
+			{
+				std::this_thread::sleep_until(tpWake);
+				// Back off when the scheduler wakes us late, creep forward again when it doesn't
+				auto dOversleep = std::chrono::steady_clock::now() - tpWake;
+				dSleepMargin = std::max(dSleepMargin - dSleepMargin / 64, dOversleep);
+			}
+
+			while (std::chrono::steady_clock::now() < tpNextFrame)
+				std::this_thread::yield();
+		}
+
+		auto dFrame = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fTargetFrameRate));
+		dSleepMargin = std::min(dSleepMargin, dFrame / 2);
+
+		// A late frame starts the schedule over rather than rushing the next few to catch up
+		tpNextFrame = std::max(tpNextFrame, tpNow) + dFrame;
+	}
+
 	void PixelGameEngine::olc_PrepareEngine()
 	{
 		// Start OpenGL, the context is owned by the game thread
@@ -2815,21 +2956,26 @@ namespace olc
 		vLayers[0].bShow = true;
 		SetDrawTarget(nullptr);
 
-		m_tp1 = std::chrono::system_clock::now();
-		m_tp2 = std::chrono::system_clock::now();
+		m_tp1 = std::chrono::steady_clock::now();
+		m_tp2 = std::chrono::steady_clock::now();
 	}
 
 
+	void PixelGameEngine::SetCorePhaseHook(std::function<void(const char* sPhase, std::chrono::steady_clock::time_point tpStart, std::chrono::steady_clock::time_point tpEnd)> f)
+	{ funcCorePhaseHook = f; }
+
 	void PixelGameEngine::olc_CoreUpdate()
 	{
 		// Handle Timing
-		m_tp2 = std::chrono::system_clock::now();
+		olc_LimitFrameRate();
+		m_tp2 = std::chrono::steady_clock::now();
 		std::chrono::duration<float> elapsedTime = m_tp2 - m_tp1;
 		m_tp1 = m_tp2;
 
 		// Our time per frame coefficient
 		float fElapsedTime = elapsedTime.count();
 		fLastElapsed = fElapsedTime;
+		frameTimes.Add(fElapsedTime);
 
 		// Some platforms will need to check for events
 		platform->HandleSystemEvent();
@@ -2866,11 +3012,24 @@ namespace olc
 		nMouseWheelDelta = nMouseWheelDeltaCache;
 		nMouseWheelDeltaCache = 0;
 
+		// Phase timing costs nothing unless somebody is listening
+		std::chrono::steady_clock::time_point tpPhase;
+		auto BeginPhase = [&]()
+		{
+			if (funcCorePhaseHook) tpPhase = std::chrono::steady_clock::now();
+		};
+		auto EndPhase = [&](const char* sPhase)
+		{
+			if (funcCorePhaseHook) funcCorePhaseHook(sPhase, tpPhase, std::chrono::steady_clock::now());
+		};
+
 		//	renderer->ClearBuffer(olc::BLACK, true);
 
 			// Handle Frame Update
+		BeginPhase();
 		if (!OnUserUpdate(fElapsedTime))
 			bAtomActive = false;
+		EndPhase("OnUserUpdate");
 
 		// Display Frame
 		renderer->UpdateViewport(vViewPos, vViewSize);
@@ -2887,19 +3046,23 @@ namespace olc
 			{
 				if (layer->funcHook == nullptr)
 				{
+					BeginPhase();
 					renderer->ApplyTexture(layer->nResID);
 					if (layer->bUpdate)
 					{
 						renderer->UpdateTexture(layer->nResID, layer->pDrawTarget);
 						layer->bUpdate = false;
 					}
+					EndPhase("LayerUpload");
 
+					BeginPhase();
 					renderer->DrawLayerQuad(layer->vOffset, layer->vScale, layer->tint);
 
 					// Display Decals in order for this layer
 					for (auto& decal : layer->vecDecalInstance)
 						renderer->DrawDecalQuad(decal);
 					layer->vecDecalInstance.clear();
+					EndPhase("DecalDraw");
 				}
 				else
 				{
@@ -2910,7 +3073,9 @@ namespace olc
 		}
 
 		// Present Graphics to screen
+		BeginPhase();
 		renderer->DisplayFrame();
+		EndPhase("DisplayFrame");
 
 		// Update Title Bar
 		fFrameTimer += fElapsedTime;
@@ -2983,6 +3148,7 @@ namespace olc
 	olc::PixelGameEngine* olc::PGEX::pge = nullptr;
 	olc::PixelGameEngine* olc::Platform::ptrPGE = nullptr;
 	olc::PixelGameEngine* olc::Renderer::ptrPGE = nullptr;
+	uint32_t olc::Renderer::nTextureCount = 0;
 	std::unique_ptr<ImageLoader> olc::Sprite::loader = nullptr;
 };
 
@@ -3324,6 +3490,91 @@ namespace olc
 
 
 
+// O------------------------------------------------------------------------------O
+// | START RENDERER: Null (headless, nothing is ever drawn)                       |
+// O------------------------------------------------------------------------------O
+#if defined(OLC_GFX_NULL)
+namespace olc
+{
+	class Renderer_Null : public olc::Renderer
+	{
+	private:
+		uint32_t nNextTextureID = 1;
+
+	public:
+		void PrepareDevice() override
+		{}
+
+		olc::rcode CreateDevice(std::vector<void*> params, bool bFullScreen, bool bVSYNC) override
+		{
+			UNUSED(params);
+			UNUSED(bFullScreen);
+			UNUSED(bVSYNC);
+			return olc::rcode::OK;
+		}
+
+		olc::rcode DestroyDevice() override
+		{ return olc::rcode::OK; }
+
+		void DisplayFrame() override
+		{}
+
+		void PrepareDrawing() override
+		{}
+
+		void SetDecalMode(const olc::DecalMode& mode) override
+		{ UNUSED(mode); }
+
+		void DrawLayerQuad(const olc::vf2d& offset, const olc::vf2d& scale, const olc::Pixel tint) override
+		{
+			UNUSED(offset);
+			UNUSED(scale);
+			UNUSED(tint);
+		}
+
+		void DrawDecalQuad(const olc::DecalInstance& decal) override
+		{ UNUSED(decal); }
+
+		uint32_t CreateTexture(const uint32_t width, const uint32_t height, const bool filtered) override
+		{
+			UNUSED(width);
+			UNUSED(height);
+			UNUSED(filtered);
+			return nNextTextureID++;
+		}
+
+		uint32_t DeleteTexture(const uint32_t id) override
+		{ return id; }
+
+		void UpdateTexture(uint32_t id, olc::Sprite* spr) override
+		{
+			UNUSED(id);
+			UNUSED(spr);
+		}
+
+		void ApplyTexture(uint32_t id) override
+		{ UNUSED(id); }
+
+		void ClearBuffer(olc::Pixel p, bool bDepth) override
+		{
+			UNUSED(p);
+			UNUSED(bDepth);
+		}
+
+		void UpdateViewport(const olc::vi2d& pos, const olc::vi2d& size) override
+		{
+			UNUSED(pos);
+			UNUSED(size);
+		}
+	};
+}
+#endif
+// O------------------------------------------------------------------------------O
+// | END RENDERER: Null                                                           |
+// O------------------------------------------------------------------------------O
+
+
+
 
 // O------------------------------------------------------------------------------O
 // | START IMAGE LOADER: GDI+, Windows Only, always exists, a little slow         |
@@ -4337,6 +4588,95 @@ namespace olc {
 
 
 
+
+// O------------------------------------------------------------------------------O
+// | START PLATFORM: HEADLESS (no window, input is scripted)                      |
+// O------------------------------------------------------------------------------O
+#if defined(OLC_PLATFORM_HEADLESS)
+namespace olc
+{
+	class Platform_Headless : public olc::Platform
+	{
+	public:
+		// Number of frames to run before terminating, 0 runs until the user quits
+		static uint64_t nMaxFrames;
+		// Called at the start of every frame, use olc_UpdateKeyState() and
+		// friends to feed input into the engine
+		static std::function<void(olc::PixelGameEngine* pge, uint64_t nFrame)> funcInput;
+
+	private:
+		uint64_t nFrame = 0;
+
+	public:
+		virtual olc::rcode ApplicationStartUp() override
+		{ return olc::rcode::OK; }
+
+		virtual olc::rcode ApplicationCleanUp() override
+		{ return olc::rcode::OK; }
+
+		virtual olc::rcode ThreadStartUp() override
+		{ return olc::rcode::OK; }
+
+		virtual olc::rcode ThreadCleanUp() override
+		{
+			renderer->DestroyDevice();
+			return olc::OK;
+		}
+
+		virtual olc::rcode CreateGraphics(bool bFullScreen, bool bEnableVSYNC, const olc::vi2d& vViewPos, const olc::vi2d& vViewSize) override
+		{
+			if (renderer->CreateDevice({}, bFullScreen, bEnableVSYNC) == olc::rcode::OK)
+			{
+				renderer->UpdateViewport(vViewPos, vViewSize);
+				return olc::rcode::OK;
+			}
+			else
+				return olc::rcode::FAIL;
+		}
+
+		virtual olc::rcode CreateWindowPane(const olc::vi2d& vWindowPos, olc::vi2d& vWindowSize, bool bFullScreen) override
+		{
+			UNUSED(vWindowPos);
+			UNUSED(vWindowSize);
+			UNUSED(bFullScreen);
+			// There is nobody to steal focus, so the "window" always has it
+			ptrPGE->olc_UpdateKeyFocus(true);
+			ptrPGE->olc_UpdateMouseFocus(true);
+			return olc::OK;
+		}
+
+		virtual olc::rcode SetWindowTitle(const std::string& s) override
+		{
+			UNUSED(s);
+			return olc::OK;
+		}
+
+		virtual olc::rcode StartSystemEventLoop() override
+		{ return olc::OK; }
+
+		virtual olc::rcode HandleSystemEvent() override
+		{
+			if (funcInput) funcInput(ptrPGE, nFrame);
+
+			// The current frame still runs to completion after this
+			if (nMaxFrames > 0 && nFrame + 1 >= nMaxFrames)
+				ptrPGE->olc_Terminate();
+
+			nFrame++;
+			return olc::OK;
+		}
+	};
+
+	uint64_t Platform_Headless::nMaxFrames = 0;
+	std::function<void(olc::PixelGameEngine*, uint64_t)> Platform_Headless::funcInput = nullptr;
+}
+#endif
+// O------------------------------------------------------------------------------O
+// | END PLATFORM: HEADLESS                                                       |
+// O------------------------------------------------------------------------------O
+
+
+
 namespace olc
 {
 	void PixelGameEngine::olc_ConfigureSystem()
@@ -4369,6 +4709,10 @@ namespace olc
 		platform = std::make_unique<olc::Platform_GLUT>();
 #endif
 
+#if defined(OLC_PLATFORM_HEADLESS)
+		platform = std::make_unique<olc::Platform_Headless>();
+#endif
+
 
 
 #if defined(OLC_GFX_OPENGL10)
@@ -4391,6 +4735,10 @@ namespace olc
 		renderer = std::make_unique<olc::Renderer_DX11>();
 #endif
 
+#if defined(OLC_GFX_NULL)
+		renderer = std::make_unique<olc::Renderer_Null>();
+#endif
+
 		// Associate components with PGE instance
 		platform->ptrPGE = this;
 		renderer->ptrPGE = this;